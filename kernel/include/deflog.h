@@ -0,0 +1,127 @@
+/**
+ * @file   deflog.h
+ *
+ * @brief  Deferred binary logging, shared by the kernel, user_common and
+ *         the host decoder (util/deflog_decode.c).
+ *
+ *         A log call does not format anything. The format string goes into
+ *         the .deflog section, which the linker keeps in the ELF but not on
+ *         the target (see linker_template.lds), and the call only copies
+ *         the string's offset in that section and the raw 32-bit arguments
+ *         into an MPSC ring as one record. The UART driver sends records
+ *         as they are when no text is queued, and the host decoder renders
+ *         them with the strings from the ELF.
+ *
+ *         Record on the wire, little endian:
+ *           DEFLOG_MARKER, number of arguments, 16-bit string ID, then
+ *           4 bytes per argument.
+ *
+ *         Every argument is passed as 32 bits, so %d %i %u %x %X %o %c %p
+ *         work and %s, %f and 64-bit conversions do not.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _DEFLOG_H_
+#define _DEFLOG_H_
+
+#include <stdint.h>
+
+/**
+ * @brief      First byte of every record. Text output is ASCII or UTF-8,
+ *             neither of which ever contains 0xFF.
+ */
+#define DEFLOG_MARKER 0xFF
+
+/** @brief Bytes before the arguments of a record. */
+#define DEFLOG_HEADER 4
+
+/** @brief Most arguments a record can carry. */
+#define DEFLOG_MAX_ARGS 8
+
+/** @brief Largest record in bytes. */
+#define DEFLOG_MAX_RECORD (DEFLOG_HEADER + 4 * DEFLOG_MAX_ARGS)
+
+/**
+ * @brief      String ID of scheduler trace records (sched_trace.h), which
+ *             util/sched_trace_json.c reads. The .deflog section never
+ *             grows that large.
+ */
+#define DEFLOG_ID_SCHED_TRACE 0xFFFF
+
+/**
+ * @brief      String ID of text records: the arguments hold the text
+ *             itself, 4 bytes each in order, padded with '\0'.
+ */
+#define DEFLOG_ID_TEXT 0xFFFE
+
+/** @brief Size in bytes of a record with nargs arguments. */
+#define DEFLOG_RECORD_SIZE(nargs) (DEFLOG_HEADER + 4 * (nargs))
+
+#ifndef DEFLOG_HOST
+#include <ring_buffer.h>
+
+/**
+ * @brief      Writes one record. Reserving the space is a handful of
+ *             LDREX/STREX, the rest are plain stores.
+ *
+ * @param      rb     The log ring.
+ * @param[in]  id     Offset of the format string in .deflog.
+ * @param[in]  args   The arguments.
+ * @param[in]  nargs  Number of arguments, at most DEFLOG_MAX_ARGS.
+ *
+ * @return     0 on success, -1 if the ring is full and the record was
+ *             dropped.
+ */
+static inline int deflog_write(ring_buffer_t *rb, uint32_t id, const uint32_t *args, uint32_t nargs)
+{
+  uint32_t pos;
+  if (ring_mpsc_reserve(rb, DEFLOG_RECORD_SIZE(nargs), &pos) < 0) {
+    return -1;
+  }
+
+  uint8_t *data = rb->data;
+  uint32_t mask = rb->mask;
+  data[pos & mask] = DEFLOG_MARKER;
+  data[(pos + 1) & mask] = nargs;
+  data[(pos + 2) & mask] = id;
+  data[(pos + 3) & mask] = id >> 8;
+  pos += DEFLOG_HEADER;
+
+  for (uint32_t i = 0; i < nargs; i++) {
+    uint32_t arg = args[i];
+    data[pos & mask] = arg;
+    data[(pos + 1) & mask] = arg >> 8;
+    data[(pos + 2) & mask] = arg >> 16;
+    data[(pos + 3) & mask] = arg >> 24;
+    pos += 4;
+  }
+
+  ring_mpsc_commit(rb);
+  return 0;
+}
+
+/**
+ * @brief      Logs a record into a ring. The format string is a string
+ *             literal and every argument converts to uint32_t.
+ *
+ *             The string ID is the address of a static in .deflog, which
+ *             the linker places at 0, so it is a link-time constant.
+ *
+ * @return     0 on success, -1 if the record was dropped.
+ */
+#define deflog_record(rb, fmt, ...)                                           \
+  ({                                                                          \
+    static const char _deflog_fmt[] __attribute__((section(".deflog"))) = fmt; \
+    const uint32_t _deflog_args[] = { 0, ##__VA_ARGS__ };                     \
+    _Static_assert(sizeof(_deflog_args) / 4 - 1 <= DEFLOG_MAX_ARGS,           \
+                   "too many deflog arguments");                              \
+    deflog_write((rb), (uint32_t)_deflog_fmt, _deflog_args + 1,               \
+                 sizeof(_deflog_args) / 4 - 1);                               \
+  })
+
+#endif /* DEFLOG_HOST */
+
+#endif /* _DEFLOG_H_ */
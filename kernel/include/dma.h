@@ -0,0 +1,71 @@
+/**
+ * @file   dma.h
+ *
+ * @brief  Register map of the DMA controllers and the stream bits the
+ *         drivers use.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _DMA_H_
+#define _DMA_H_
+
+#include <unistd.h>
+
+/** @brief One DMA stream. */
+struct dma_stream_map {
+  volatile uint32_t CR;    /**< Configuration Register */
+  volatile uint32_t NDTR;  /**< Number of Data Register, counts down */
+  volatile uint32_t PAR;   /**< Peripheral Address Register */
+  volatile uint32_t M0AR;  /**< Memory 0 Address Register */
+  volatile uint32_t M1AR;  /**< Memory 1 Address Register */
+  volatile uint32_t FCR;   /**< FIFO Control Register */
+};
+
+/** @brief The DMA controller register map. */
+struct dma_reg_map {
+  volatile uint32_t LISR;   /**< Low Interrupt Status Register, streams 0-3 */
+  volatile uint32_t HISR;   /**< High Interrupt Status Register, streams 4-7 */
+  volatile uint32_t LIFCR;  /**< Low Interrupt Flag Clear Register */
+  volatile uint32_t HIFCR;  /**< High Interrupt Flag Clear Register */
+  struct dma_stream_map S[8]; /**< The streams */
+};
+
+/** @brief Base address for DMA1 */
+#define DMA1_BASE (struct dma_reg_map *) 0x40026000
+
+/** @brief DMA1 clock enable bit in RCC AHB1ENR */
+#define DMA1_CLOCK_EN (1 << 21)
+
+/** @brief Stream configuration bits */
+//@{
+#define DMA_SxCR_EN      (1 << 0)   /**< Stream enable */
+#define DMA_SxCR_TEIE    (1 << 2)   /**< Transfer error interrupt enable */
+#define DMA_SxCR_HTIE    (1 << 3)   /**< Half transfer interrupt enable */
+#define DMA_SxCR_TCIE    (1 << 4)   /**< Transfer complete interrupt enable */
+#define DMA_SxCR_P2M     (0 << 6)   /**< Peripheral to memory */
+#define DMA_SxCR_M2P     (1 << 6)   /**< Memory to peripheral */
+#define DMA_SxCR_CIRC    (1 << 8)   /**< Circular mode */
+#define DMA_SxCR_MINC    (1 << 10)  /**< Memory address increment */
+#define DMA_SxCR_CHSEL(ch) ((uint32_t)(ch) << 25) /**< Channel select */
+//@}
+
+/**
+ * @brief Shift of a stream's flags within its LISR/HISR half: streams 0/4
+ *        start at bit 0, 1/5 at 6, 2/6 at 16 and 3/7 at 22.
+ */
+#define DMA_FLAG_SHIFT(stream) ((((stream) & 2) ? 16 : 0) + (((stream) & 1) ? 6 : 0))
+
+/** @brief Stream flags, shifted by DMA_FLAG_SHIFT() */
+//@{
+#define DMA_FEIF  (1 << 0)  /**< FIFO error */
+#define DMA_DMEIF (1 << 2)  /**< Direct mode error */
+#define DMA_TEIF  (1 << 3)  /**< Transfer error */
+#define DMA_HTIF  (1 << 4)  /**< Half transfer */
+#define DMA_TCIF  (1 << 5)  /**< Transfer complete */
+#define DMA_ALL_FLAGS (DMA_FEIF | DMA_DMEIF | DMA_TEIF | DMA_HTIF | DMA_TCIF)
+//@}
+
+#endif /* _DMA_H_ */
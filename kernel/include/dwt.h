@@ -0,0 +1,35 @@
+/**
+ * @file   dwt.h
+ *
+ * @brief  Cycle counter of the Data Watchpoint and Trace unit.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _DWT_H_
+#define _DWT_H_
+
+#include <unistd.h>
+
+/** @brief Address of DWT_CYCCNT, the free running core clock counter. */
+#define DWT_CYCCNT ((volatile uint32_t *) 0xE0001004)
+
+/**
+ * @brief      Enables trace and starts the cycle counter from 0.
+ */
+void dwt_init( void );
+
+/**
+ * @brief      Reads the cycle counter. It wraps every 2^32 core clocks
+ *             (about 268 s at 16 MHz), so only differences are meaningful.
+ *
+ * @return     The current cycle count.
+ */
+__attribute__((always_inline)) static inline uint32_t dwt_get_cycles( void )
+{
+  return *DWT_CYCCNT;
+}
+
+#endif /* _DWT_H_ */
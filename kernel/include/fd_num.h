@@ -0,0 +1,41 @@
+/**
+ * @file   fd_num.h
+ *
+ * @brief  File descriptors the kernel opens for every program, shared by
+ *         the kernel and user code. Each one is bound to a device when the
+ *         kernel starts, so there is no open().
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _FD_NUM_H_
+#define _FD_NUM_H_
+
+/** @brief Console on the UART, with echo and line editing on input */
+//@{
+#define FD_STDIN   0
+#define FD_STDOUT  1
+#define FD_STDERR  2
+//@}
+
+/** @brief 16x2 character LCD on I2C1, write only. '\n' moves to the
+ *         second row, '\f' clears the display. */
+#define FD_LCD     3
+
+/** @brief 3x4 keypad, read only. Every read returns one key press. */
+#define FD_KEYPAD  4
+
+/** @brief Trace text, write only. Goes to ITM stimulus port 0 when the
+ *         kernel is built with ITM_TRACE, into the kernel log ring on the
+ *         UART otherwise, next to the scheduler trace dumps. */
+#define FD_TRACE   5
+
+/** @brief Discards writes, reads hit end of file at once. */
+#define FD_NULL    6
+
+/** @brief Size of the file descriptor table. */
+#define FD_MAX     7
+
+#endif /* _FD_NUM_H_ */
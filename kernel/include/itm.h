@@ -0,0 +1,147 @@
+/**
+ * @file   itm.h
+ *
+ * @brief  Kernel trace events on the ITM stimulus ports, sent out over SWO
+ *         by the debug hardware without involving the UART. Decoded on the
+ *         host by util/itm_timeline.c.
+ *
+ *         Every event is one 32-bit stimulus write: the event data in the
+ *         top byte and the low 24 bits of DWT_CYCCNT below it. SysTick is
+ *         traced as well, so there is an event at least every tick and the
+ *         host can always unwrap the 24-bit time.
+ *
+ *         Events are dropped, not waited for, when the ITM FIFO is full, so
+ *         a hook costs a few cycles whatever the SWO rate. Compiled in with
+ *         ITM_TRACE (kernel_config.h), to nothing otherwise.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _ITM_H_
+#define _ITM_H_
+
+#include <unistd.h>
+#include <dwt.h>
+#include <kernel_config.h>
+
+/** @brief Stimulus ports, all privileged (ITM_TPR) */
+//@{
+#define ITM_PORT_TEXT      0   /**< Text written to FD_TRACE, one byte per write. */
+#define ITM_PORT_SWITCH    1   /**< Context switch, data (to << 4) | from. */
+#define ITM_PORT_SVC_ENTER 2   /**< Syscall entry, data is the SVC number. */
+#define ITM_PORT_SVC_EXIT  3   /**< Syscall exit, data is the SVC number. */
+#define ITM_PORT_ISR_ENTER 4   /**< Interrupt entry, data is the exception number. */
+#define ITM_PORT_ISR_EXIT  5   /**< Interrupt exit, data is the exception number. */
+#define ITM_PORT_MARKER    6   /**< User marker, data is the marker ID. */
+//@}
+
+/** @brief Bits of DWT_CYCCNT carried by every event */
+#define ITM_TIME_BITS 24
+
+/** @brief Default SWO bit rate, what an ST-Link can receive */
+#define ITM_SWO_BAUD 2000000
+
+/** @brief Address of the first stimulus port */
+#define ITM_STIM ((volatile uint32_t *) 0xE0000000)
+
+/** @brief Set in a stimulus port when it can take another write */
+#define ITM_FIFOREADY 1
+
+/** @brief Events dropped because the ITM FIFO was full. */
+extern volatile uint32_t itm_dropped;
+
+/**
+ * @brief      Routes SWO to PB3 and enables the kernel stimulus ports.
+ *
+ * @param[in]  swo_baud  SWO bit rate, 0 for ITM_SWO_BAUD.
+ */
+void itm_init( uint32_t swo_baud );
+
+/**
+ * @brief      Sends one event. An ISR may fill the FIFO between the check
+ *             and the write, the event is then lost without being counted.
+ *
+ * @param[in]  port  Stimulus port.
+ * @param[in]  data  Event data, 8 bits.
+ */
+__attribute__((always_inline)) static inline void itm_event( uint32_t port, uint32_t data )
+{
+#if ITM_TRACE
+  volatile uint32_t *stim = &ITM_STIM[port];
+  if (*stim & ITM_FIFOREADY) {
+    *stim = (data << ITM_TIME_BITS) | (dwt_get_cycles() & ((1 << ITM_TIME_BITS) - 1));
+  }
+  else {
+    itm_dropped++;
+  }
+#else
+  (void)port;
+  (void)data;
+#endif
+}
+
+/**
+ * @brief      Reads the number of the active exception.
+ */
+__attribute__((always_inline)) static inline uint32_t itm_ipsr( void )
+{
+  uint32_t ipsr;
+  __asm volatile("mrs %0, ipsr" : "=r"(ipsr));
+  return ipsr & 0x1FF;
+}
+
+/** @brief Hooks called by the kernel */
+//@{
+__attribute__((always_inline)) static inline void itm_switch( uint32_t from, uint32_t to )
+{
+  itm_event(ITM_PORT_SWITCH, (to << 4) | from);
+}
+
+__attribute__((always_inline)) static inline void itm_svc_enter( uint32_t svc_number )
+{
+  itm_event(ITM_PORT_SVC_ENTER, svc_number);
+}
+
+__attribute__((always_inline)) static inline void itm_svc_exit( uint32_t svc_number )
+{
+  itm_event(ITM_PORT_SVC_EXIT, svc_number);
+}
+
+__attribute__((always_inline)) static inline void itm_isr_enter( void )
+{
+#if ITM_TRACE
+  itm_event(ITM_PORT_ISR_ENTER, itm_ipsr());
+#endif
+}
+
+__attribute__((always_inline)) static inline void itm_isr_exit( void )
+{
+#if ITM_TRACE
+  itm_event(ITM_PORT_ISR_EXIT, itm_ipsr());
+#endif
+}
+//@}
+
+/**
+ * @brief      Sends text on ITM_PORT_TEXT. Unlike events, text waits for
+ *             room in the FIFO instead of being dropped.
+ *
+ * @param[in]  buf   The bytes.
+ * @param[in]  len   Number of bytes.
+ *
+ * @return     len, -1 if tracing is compiled out.
+ */
+int itm_write( const char *buf, int len );
+
+/**
+ * @brief      Emits a user marker, for trace_marker().
+ *
+ * @param[in]  id    Marker ID, 8 bits.
+ *
+ * @return     0 on success, -1 if tracing is compiled out.
+ */
+int sys_trace_marker( uint32_t id );
+
+#endif /* _ITM_H_ */
@@ -0,0 +1,96 @@
+/**
+ * @file   kernel_config.h
+ *
+ * @brief  Compile-time switches for optional kernel features. Every value
+ *         can be overridden from the command line, e.g.
+ *         make ARG=-DDEADLOCK_DETECTION=0
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _KERNEL_CONFIG_H_
+#define _KERNEL_CONFIG_H_
+
+/** @brief Deadlock policies */
+//@{
+#define DEADLOCK_FAIL_LOCK    0   /**< The lock that would close the cycle fails. */
+#define DEADLOCK_KILL_LOWEST  1   /**< The lowest priority thread in the cycle is killed. */
+//@}
+
+/**
+ * @brief      Set to 0 to compile out wait-for graph cycle detection in
+ *             sys_mutex_lock().
+ */
+#ifndef DEADLOCK_DETECTION
+#define DEADLOCK_DETECTION 1
+#endif
+
+/**
+ * @brief      What to do when a mutex lock would deadlock.
+ */
+#ifndef DEADLOCK_POLICY
+#define DEADLOCK_POLICY DEADLOCK_FAIL_LOCK
+#endif
+
+/**
+ * @brief      Set to 0 to compile out the per-mutex contention and hold time
+ *             counters.
+ */
+#ifndef MUTEX_PROFILING
+#define MUTEX_PROFILING 1
+#endif
+
+/**
+ * @brief      Set to 0 to send UART output one byte per TXE interrupt
+ *             instead of by DMA1 Stream6.
+ */
+#ifndef UART_TX_DMA
+#define UART_TX_DMA 1
+#endif
+
+/**
+ * @brief      Number of UART transmit rings, each serving an equal share of
+ *             the thread priorities. The highest band with data is sent
+ *             first. Must be a power of two, 1 shares one ring between all
+ *             threads.
+ */
+#ifndef UART_TX_BANDS
+#define UART_TX_BANDS 4
+#endif
+
+/**
+ * @brief      Set to 0 to receive UART input one byte per RXNE interrupt
+ *             instead of into a circular DMA1 Stream5 buffer.
+ */
+#ifndef UART_RX_DMA
+#define UART_RX_DMA 1
+#endif
+
+/**
+ * @brief      Set to 1 to emit context switch, syscall, interrupt and user
+ *             marker events on the ITM stimulus ports (itm.h). Claims PB3
+ *             for SWO.
+ */
+#ifndef ITM_TRACE
+#define ITM_TRACE 0
+#endif
+
+/**
+ * @brief      Set to 0 to compile out the in-RAM scheduler trace
+ *             (sched_trace.h).
+ */
+#ifndef SCHED_TRACE
+#define SCHED_TRACE 1
+#endif
+
+/**
+ * @brief      Number of 8-byte records the scheduler trace keeps. Must be a
+ *             power of two.
+ */
+#ifndef SCHED_TRACE_RECORDS
+#define SCHED_TRACE_RECORDS 256
+#endif
+
+#endif /* _KERNEL_CONFIG_H_ */
@@ -0,0 +1,86 @@
+/**
+ * @file   klog.h
+ *
+ * @brief  Kernel side of deferred logging: klog() for kernel code, the
+ *         ring registered by user code, and the drain used by the UART
+ *         driver.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _KLOG_H_
+#define _KLOG_H_
+
+#include <unistd.h>
+#include <deflog.h>
+
+/** @brief Ring of the records logged by the kernel. */
+extern ring_buffer_t klog_ring;
+
+/**
+ * @brief      Deferred printk(). Costs tens of cycles instead of formatting
+ *             on the target, so it is fine in SysTick and other hot paths.
+ *             See deflog.h for the supported conversions. Records logged
+ *             while the ring is full are dropped.
+ */
+#define klog(fmt, ...) deflog_record(&klog_ring, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief      Queues text in the kernel log ring as DEFLOG_ID_TEXT records,
+ *             waiting for the UART to make room.
+ *
+ * @param[in]  buf   The text.
+ * @param[in]  len   Number of bytes.
+ *
+ * @return     len.
+ */
+int klog_write( const char *buf, int len );
+
+/**
+ * @brief      Forgets the user ring, called when the UART is (re)set up.
+ */
+void klog_init( void );
+
+/**
+ * @brief      Whether any log ring has records to send.
+ */
+int deflog_pending( void );
+
+/**
+ * @brief      Next bytes to send, stored contiguously. Whole records where
+ *             possible; a record that wraps the end of its ring is sent in
+ *             two parts, and deflog_in_record() then tells the driver to
+ *             send nothing else in between.
+ *
+ * @param[out] data  Where the bytes start.
+ * @param[in]  max   Most bytes wanted.
+ *
+ * @return     Number of bytes, 0 if there is nothing to send.
+ */
+uint32_t deflog_peek( const uint8_t **data, uint32_t max );
+
+/**
+ * @brief      Releases n bytes returned by the last deflog_peek() once they
+ *             were sent.
+ *
+ * @param[in]  n     Number of bytes sent.
+ */
+void deflog_consume( uint32_t n );
+
+/**
+ * @brief      Whether a record has been partly sent.
+ */
+int deflog_in_record( void );
+
+/**
+ * @brief      Registers the ring user code logs into.
+ *
+ * @param      ring  The user ring, NULL to stop draining it.
+ *
+ * @return     0 on success, -1 if the ring is not initialized.
+ */
+int sys_deflog_register( ring_buffer_t *ring );
+
+#endif /* _KLOG_H_ */
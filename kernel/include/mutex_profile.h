@@ -0,0 +1,97 @@
+/**
+ * @file   mutex_profile.h
+ *
+ * @brief  Per-mutex contention and hold time counters. The hooks are called
+ *         from the mutex code and compile to nothing when MUTEX_PROFILING
+ *         is 0.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _MUTEX_PROFILE_H_
+#define _MUTEX_PROFILE_H_
+
+#include <unistd.h>
+#include <kernel_config.h>
+#include <dwt.h>
+
+/**
+ * @brief      Counters kept for every mutex. Times are in core cycles.
+ */
+typedef struct {
+  uint32_t acquisitions;    /**< Successful locks. */
+  uint32_t contended;       /**< Locks that had to wait for the owner. */
+  uint64_t hold_total;      /**< Sum of all hold times. */
+  uint32_t hold_max;        /**< Longest hold time. */
+  uint64_t wait_total;      /**< Sum of the wait times of contended locks. */
+  uint32_t wait_max;        /**< Longest wait time. */
+  uint32_t longest_holder;  /**< Thread that set hold_max. */
+  uint32_t hold_start;      /**< Cycle count when the current owner got it. */
+} mutex_profile_t;
+
+#if MUTEX_PROFILING
+
+/**
+ * @brief      Resets the counters of a mutex.
+ */
+static inline void mutex_profile_init( mutex_profile_t *p )
+{
+  p->acquisitions = 0;
+  p->contended = 0;
+  p->hold_total = 0;
+  p->hold_max = 0;
+  p->wait_total = 0;
+  p->wait_max = 0;
+  p->longest_holder = 0;
+  p->hold_start = 0;
+}
+
+/**
+ * @brief      Records that a thread got the mutex.
+ */
+static inline void mutex_profile_take( mutex_profile_t *p )
+{
+  p->acquisitions++;
+  p->hold_start = dwt_get_cycles();
+}
+
+/**
+ * @brief      Records that the owner released the mutex.
+ */
+static inline void mutex_profile_give( mutex_profile_t *p, uint32_t owner )
+{
+  uint32_t held = dwt_get_cycles() - p->hold_start;
+  p->hold_total += held;
+  if (held > p->hold_max) {
+    p->hold_max = held;
+    p->longest_holder = owner;
+  }
+}
+
+/**
+ * @brief      Records a contended lock that waited since wait_start.
+ */
+static inline void mutex_profile_wait( mutex_profile_t *p, uint32_t wait_start )
+{
+  uint32_t waited = dwt_get_cycles() - wait_start;
+  p->contended++;
+  p->wait_total += waited;
+  if (waited > p->wait_max) {
+    p->wait_max = waited;
+  }
+}
+
+#else
+
+/* The arguments are dropped unevaluated, so kmutex_t does not need the
+ * profile field at all */
+#define mutex_profile_init( p )                do {} while (0)
+#define mutex_profile_take( p )                do {} while (0)
+#define mutex_profile_give( p, owner )         do {} while (0)
+#define mutex_profile_wait( p, wait_start )    do {} while (0)
+
+#endif /* MUTEX_PROFILING */
+
+#endif /* _MUTEX_PROFILE_H_ */
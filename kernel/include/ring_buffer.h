@@ -0,0 +1,362 @@
+/**
+ * @file   ring_buffer.h
+ *
+ * @brief  Lock-free byte ring buffers shared by the kernel and user_common.
+ *
+ *         Capacities are powers of two and the head/tail indices run freely,
+ *         so the fill level is always head - tail and wrapping is a mask.
+ *
+ *         SPSC: exactly one producer context and one consumer context, e.g.
+ *         an ISR feeding a thread. No atomics are needed.
+ *
+ *         MPSC: any number of producers that may preempt each other (threads,
+ *         SVC, SysTick, ISRs on this single core) and one consumer. Producers
+ *         reserve space with LDREX/STREX and the data becomes visible to the
+ *         consumer once no producer is between reserve and commit. Threads
+ *         can be switched out in the middle of a push, so a producer that
+ *         finishes while another one is still writing leaves publishing to
+ *         that one. No producer ever waits for another one.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+#include <stdint.h>
+
+#define intrinsic __attribute__((always_inline)) static inline
+
+/**
+ * @brief      Ring buffer state. The producer owns head (and reserve/writers
+ *             for MPSC), the consumer owns tail.
+ */
+typedef struct {
+  uint8_t *data;               /**< Storage of capacity bytes. */
+  uint32_t mask;               /**< capacity - 1. */
+  volatile uint32_t head;      /**< End of the data visible to the consumer. */
+  volatile uint32_t tail;      /**< Next byte the consumer reads. */
+  volatile uint32_t reserve;   /**< MPSC: end of the space handed to producers. */
+  volatile uint32_t writers;   /**< MPSC: producers between reserve and commit. */
+} ring_buffer_t;
+
+/**
+ * @brief      Data memory barrier, also a compiler barrier.
+ */
+intrinsic void ring_dmb(void)
+{
+  __asm volatile("dmb" ::: "memory");
+}
+
+/**
+ * @brief      Exclusive load.
+ */
+intrinsic uint32_t ring_ldrex(volatile uint32_t *addr)
+{
+  uint32_t result;
+  __asm volatile("ldrex %0, [%1]" : "=r"(result) : "r"(addr) : "memory");
+  return result;
+}
+
+/**
+ * @brief      Exclusive store.
+ *
+ * @return     0 if the store happened, 1 if it has to be retried.
+ */
+intrinsic uint32_t ring_strex(volatile uint32_t *addr, uint32_t val)
+{
+  uint32_t result;
+  __asm volatile("strex %0, %2, [%1]" : "=&r"(result) : "r"(addr), "r"(val) : "memory");
+  return result;
+}
+
+/**
+ * @brief      Clears the local exclusive monitor.
+ */
+intrinsic void ring_clrex(void)
+{
+  __asm volatile("clrex" ::: "memory");
+}
+
+/**
+ * @brief      Initializes a ring buffer over caller supplied storage.
+ *
+ * @param      rb        The ring buffer.
+ * @param      data      Storage of capacity bytes.
+ * @param[in]  capacity  Size of data, must be a power of two.
+ *
+ * @return     0 on success, -1 if capacity is not a power of two.
+ */
+static inline int ring_init(ring_buffer_t *rb, uint8_t *data, uint32_t capacity)
+{
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+    return -1;
+  }
+  rb->data = data;
+  rb->mask = capacity - 1;
+  rb->head = 0;
+  rb->tail = 0;
+  rb->reserve = 0;
+  rb->writers = 0;
+  return 0;
+}
+
+/**
+ * @brief      Number of bytes the consumer can read.
+ */
+intrinsic uint32_t ring_count(const ring_buffer_t *rb)
+{
+  return rb->head - rb->tail;
+}
+
+/**
+ * @brief      Number of bytes a producer can write.
+ */
+intrinsic uint32_t ring_free(const ring_buffer_t *rb)
+{
+  return rb->mask + 1 - (rb->reserve - rb->tail);
+}
+
+/**
+ * @brief      Copies bytes into the ring starting at a free running index.
+ */
+static inline void ring_copy_in(ring_buffer_t *rb, uint32_t pos, const uint8_t *src, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    rb->data[(pos + i) & rb->mask] = src[i];
+  }
+}
+
+/**
+ * @brief      Copies bytes out of the ring starting at a free running index.
+ */
+static inline void ring_copy_out(const ring_buffer_t *rb, uint32_t pos, uint8_t *dst, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++) {
+    dst[i] = rb->data[(pos + i) & rb->mask];
+  }
+}
+
+/**
+ * @brief      SPSC: writes up to n bytes.
+ *
+ * @return     Number of bytes written.
+ */
+static inline uint32_t ring_spsc_push_batch(ring_buffer_t *rb, const uint8_t *src, uint32_t n)
+{
+  uint32_t head = rb->head;
+  uint32_t space = rb->mask + 1 - (head - rb->tail);
+  if (n > space) {
+    n = space;
+  }
+  ring_copy_in(rb, head, src, n);
+  ring_dmb();
+  rb->head = head + n;
+  rb->reserve = head + n;
+  return n;
+}
+
+/**
+ * @brief      SPSC: writes one byte.
+ *
+ * @return     0 on success, -1 if the ring is full.
+ */
+intrinsic int ring_spsc_push(ring_buffer_t *rb, uint8_t c)
+{
+  uint32_t head = rb->head;
+  if (head - rb->tail > rb->mask) {
+    return -1;
+  }
+  rb->data[head & rb->mask] = c;
+  ring_dmb();
+  rb->head = head + 1;
+  rb->reserve = head + 1;
+  return 0;
+}
+
+/**
+ * @brief      MPSC: drops this producer from the writer count. The last
+ *             producer to finish publishes everything reserved so far to
+ *             the consumer.
+ *
+ *             Between our decrement and the publish, a thread switch may
+ *             let another producer reserve and stop halfway through its
+ *             write. writers and reserve are therefore read inside the
+ *             exclusive access to head: any exception in between clears the
+ *             monitor and the STREX retries, so a successful store means
+ *             no producer was writing and reserve only covers written data.
+ *             If one still is, it publishes our bytes when it finishes.
+ *             head is only ever moved forward.
+ *
+ * @param      rb    The ring buffer.
+ */
+static inline void ring_mpsc_release_writer(ring_buffer_t *rb)
+{
+  uint32_t w;
+  do {
+    w = ring_ldrex(&rb->writers);
+  } while (ring_strex(&rb->writers, w - 1));
+
+  if (w != 1) {
+    return;
+  }
+
+  uint32_t h, r;
+  do {
+    h = ring_ldrex(&rb->head);
+    r = rb->reserve;
+    if (rb->writers != 0 || (int32_t)(r - h) <= 0) {
+      ring_clrex();
+      return;
+    }
+  } while (ring_strex(&rb->head, r));
+}
+
+/**
+ * @brief      MPSC: reserves n contiguous bytes (all or nothing).
+ *
+ *             Every successful reserve must be followed by ring_mpsc_commit()
+ *             once the bytes are written.
+ *
+ * @param      rb    The ring buffer.
+ * @param[in]  n     Number of bytes.
+ * @param[out] pos   Free running index of the first reserved byte.
+ *
+ * @return     0 on success, -1 if there is not enough space.
+ */
+static inline int ring_mpsc_reserve(ring_buffer_t *rb, uint32_t n, uint32_t *pos)
+{
+  uint32_t w;
+  do {
+    w = ring_ldrex(&rb->writers);
+  } while (ring_strex(&rb->writers, w + 1));
+
+  uint32_t r;
+  do {
+    r = ring_ldrex(&rb->reserve);
+    if (rb->mask + 1 - (r - rb->tail) < n) {
+      ring_clrex();
+      ring_mpsc_release_writer(rb);
+      return -1;
+    }
+  } while (ring_strex(&rb->reserve, r + n));
+
+  *pos = r;
+  return 0;
+}
+
+/**
+ * @brief      MPSC: finishes a reservation once its bytes are written.
+ *
+ * @param      rb    The ring buffer.
+ */
+intrinsic void ring_mpsc_commit(ring_buffer_t *rb)
+{
+  ring_dmb();
+  ring_mpsc_release_writer(rb);
+}
+
+/**
+ * @brief      MPSC: writes n bytes as one record (all or nothing).
+ *
+ * @return     n on success, 0 if there was not enough space.
+ */
+static inline uint32_t ring_mpsc_push_batch(ring_buffer_t *rb, const uint8_t *src, uint32_t n)
+{
+  uint32_t pos;
+  if (ring_mpsc_reserve(rb, n, &pos) < 0) {
+    return 0;
+  }
+  ring_copy_in(rb, pos, src, n);
+  ring_mpsc_commit(rb);
+  return n;
+}
+
+/**
+ * @brief      MPSC: writes one byte.
+ *
+ * @return     0 on success, -1 if the ring is full.
+ */
+intrinsic int ring_mpsc_push(ring_buffer_t *rb, uint8_t c)
+{
+  return ring_mpsc_push_batch(rb, &c, 1) ? 0 : -1;
+}
+
+/**
+ * @brief      Reads one byte. Same for both variants.
+ *
+ * @return     0 on success, -1 if the ring is empty.
+ */
+intrinsic int ring_pop(ring_buffer_t *rb, uint8_t *c)
+{
+  uint32_t tail = rb->tail;
+  if (rb->head == tail) {
+    return -1;
+  }
+  *c = rb->data[tail & rb->mask];
+  ring_dmb();
+  rb->tail = tail + 1;
+  return 0;
+}
+
+/**
+ * @brief      Reads up to n bytes. Same for both variants.
+ *
+ * @return     Number of bytes read.
+ */
+static inline uint32_t ring_pop_batch(ring_buffer_t *rb, uint8_t *dst, uint32_t n)
+{
+  uint32_t tail = rb->tail;
+  uint32_t avail = rb->head - tail;
+  if (n > avail) {
+    n = avail;
+  }
+  ring_copy_out(rb, tail, dst, n);
+  ring_dmb();
+  rb->tail = tail + n;
+  return n;
+}
+
+/**
+ * @brief      Number of readable bytes stored contiguously from the tail,
+ *             for a consumer that reads rb->data directly (e.g. by DMA).
+ *
+ * @param      rb      The ring buffer.
+ * @param[out] offset  Index into rb->data of the first readable byte.
+ *
+ * @return     Number of contiguous readable bytes.
+ */
+intrinsic uint32_t ring_peek_contiguous(const ring_buffer_t *rb, uint32_t *offset)
+{
+  uint32_t tail = rb->tail;
+  uint32_t count = rb->head - tail;
+  uint32_t to_end = rb->mask + 1 - (tail & rb->mask);
+  *offset = tail & rb->mask;
+  return count < to_end ? count : to_end;
+}
+
+/**
+ * @brief      SPSC: publishes n bytes a producer wrote directly into
+ *             rb->data (e.g. by DMA).
+ */
+intrinsic void ring_produce(ring_buffer_t *rb, uint32_t n)
+{
+  ring_dmb();
+  rb->head = rb->head + n;
+  rb->reserve = rb->head;
+}
+
+/**
+ * @brief      Releases n bytes the consumer read directly from rb->data.
+ */
+intrinsic void ring_consume(ring_buffer_t *rb, uint32_t n)
+{
+  ring_dmb();
+  rb->tail = rb->tail + n;
+}
+
+#undef intrinsic
+
+#endif /* _RING_BUFFER_H_ */
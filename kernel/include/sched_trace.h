@@ -0,0 +1,95 @@
+/**
+ * @file   sched_trace.h
+ *
+ * @brief  In-RAM scheduler trace. Context switches, period releases,
+ *         budget overruns and mutex operations are written as fixed-size
+ *         binary records into a ring that keeps the last
+ *         SCHED_TRACE_RECORDS events. sched_trace_dump() sends them over
+ *         the UART in one go, and util/sched_trace_json.c turns the
+ *         capture into Chrome trace-event JSON.
+ *
+ *         Every hook runs in SysTick or PendSV, which do not preempt each
+ *         other, or with interrupts disabled, so a record is two plain
+ *         stores and an increment. Compiled in with SCHED_TRACE
+ *         (kernel_config.h), to nothing otherwise.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SCHED_TRACE_H_
+#define _SCHED_TRACE_H_
+
+#include <unistd.h>
+#include <kernel_config.h>
+#include <dwt.h>
+
+/** @brief Events, the thread is the one the event is about */
+//@{
+#define SCHED_TRACE_START   0   /**< First record of a dump: thread is max_threads, cycles the number of records lost. */
+#define SCHED_TRACE_SWITCH  1   /**< Thread switched in, with its dynamic priority. */
+#define SCHED_TRACE_RELEASE 2   /**< Thread's period started. */
+#define SCHED_TRACE_BUDGET  3   /**< Thread used up its computation time. */
+#define SCHED_TRACE_LOCK    4   /**< Thread got a mutex, priority is after the ceiling raise. */
+#define SCHED_TRACE_BLOCK   5   /**< Thread sleeps on a mutex someone else holds. */
+#define SCHED_TRACE_UNLOCK  6   /**< Thread released a mutex, priority is after the release. */
+//@}
+
+/** @brief Mutex field of records that are not about a mutex */
+#define SCHED_TRACE_NO_MUTEX 0xFF
+
+/**
+ * @brief      One trace record. On the wire it is the deflog record
+ *             DEFLOG_ID_SCHED_TRACE with cycles and info as its two
+ *             arguments.
+ */
+typedef struct {
+  uint32_t cycles;  /**< DWT_CYCCNT when the event happened. */
+  uint32_t info;    /**< event | thread << 8 | priority << 16 | mutex << 24. */
+} sched_trace_record_t;
+
+/** @brief Packs the fields of a record. */
+#define SCHED_TRACE_INFO(event, thread, priority, mutex) \
+  ((event) | ((thread) << 8) | ((priority) << 16) | ((uint32_t)(mutex) << 24))
+
+#if SCHED_TRACE
+
+/** @brief The ring, indexed by the free running sched_trace_head. */
+extern sched_trace_record_t sched_trace_buf[SCHED_TRACE_RECORDS];
+
+/** @brief Number of records written since the last dump. */
+extern uint32_t sched_trace_head;
+
+/** @brief Set while a dump is sending the ring. */
+extern volatile uint32_t sched_trace_paused;
+
+/**
+ * @brief      Records one event, overwriting the oldest record when the
+ *             ring is full.
+ */
+__attribute__((always_inline)) static inline void sched_trace( uint32_t event, uint32_t thread, uint32_t priority, uint32_t mutex )
+{
+  if (sched_trace_paused) {
+    return;
+  }
+  sched_trace_record_t *r = &sched_trace_buf[sched_trace_head++ & (SCHED_TRACE_RECORDS - 1)];
+  r->cycles = dwt_get_cycles();
+  r->info = SCHED_TRACE_INFO(event, thread, priority, mutex);
+}
+
+#else
+
+#define sched_trace( event, thread, priority, mutex )    do {} while (0)
+
+#endif /* SCHED_TRACE */
+
+/**
+ * @brief      Sends the recorded events, oldest first, and starts over with
+ *             an empty ring. Recording stops while the records go out.
+ *
+ * @return     Number of records sent, -1 if tracing is compiled out.
+ */
+int sys_sched_trace_dump( void );
+
+#endif /* _SCHED_TRACE_H_ */
@@ -54,4 +54,97 @@
 /** @brief SVC number for servo_set() */
 #define SVC_SERVO_SET      23
 
+/** @brief SVC number for semaphore_init() */
+#define SVC_SEM_INIT       24
+/** @brief SVC number for semaphore_wait() */
+#define SVC_SEM_WAIT       25
+/** @brief SVC number for semaphore_try_wait() */
+#define SVC_SEM_TRYWAIT    26
+/** @brief SVC number for semaphore_post() */
+#define SVC_SEM_POST       27
+/** @brief SVC number for event_init() */
+#define SVC_EVT_INIT       28
+/** @brief SVC number for event_wait() */
+#define SVC_EVT_WAIT       29
+/** @brief SVC number for event_set() */
+#define SVC_EVT_SET        30
+/** @brief SVC number for event_clear() */
+#define SVC_EVT_CLEAR      31
+/** @brief SVC number for msgq_init() */
+#define SVC_MSGQ_INIT      32
+/** @brief SVC number for msgq_reserve() */
+#define SVC_MSGQ_RESERVE   33
+/** @brief SVC number for msgq_commit() */
+#define SVC_MSGQ_COMMIT    34
+/** @brief SVC number for msgq_receive() */
+#define SVC_MSGQ_RECEIVE   35
+/** @brief SVC number for msgq_release() */
+#define SVC_MSGQ_RELEASE   36
+/** @brief SVC number for msgq_high_water() */
+#define SVC_MSGQ_HWM       37
+/** @brief SVC number for mutex_lock_timed() */
+#define SVC_MUT_LOK_TIMED  38
+/** @brief SVC number for semaphore_wait_timed() */
+#define SVC_SEM_WAIT_TIMED 39
+/** @brief SVC number for event_wait_timed() */
+#define SVC_EVT_WAIT_TIMED 40
+/** @brief SVC number for mutex_declare() */
+#define SVC_MUT_DECLARE    41
+/** @brief SVC number for mutex_profile_dump() */
+#define SVC_MUT_PROFILE    42
+/** @brief SVC number for rwlock_init() */
+#define SVC_RW_INIT        43
+/** @brief SVC number for rwlock_read_lock() */
+#define SVC_RW_READ_LOCK   44
+/** @brief SVC number for rwlock_write_lock() */
+#define SVC_RW_WRITE_LOCK  45
+/** @brief SVC number for rwlock_unlock() */
+#define SVC_RW_UNLOCK      46
+/** @brief SVC number for rwlock_declare() */
+#define SVC_RW_DECLARE     47
+/** @brief SVC number for barrier_init() */
+#define SVC_BAR_INIT       48
+/** @brief SVC number for barrier_wait() */
+#define SVC_BAR_WAIT       49
+/** @brief SVC number for phase_init() */
+#define SVC_PHASE_INIT     50
+/** @brief SVC number for phase_signal() */
+#define SVC_PHASE_SIGNAL   51
+/** @brief SVC number for phase_wait() */
+#define SVC_PHASE_WAIT     52
+/** @brief SVC number for cond_init() */
+#define SVC_COND_INIT      53
+/** @brief SVC number for cond_wait() */
+#define SVC_COND_WAIT      54
+/** @brief SVC number for cond_signal() */
+#define SVC_COND_SIGNAL    55
+/** @brief SVC number for cond_broadcast() */
+#define SVC_COND_BROADCAST 56
+/** @brief SVC number for swtimer_create() */
+#define SVC_TMR_CREATE     57
+/** @brief SVC number for swtimer_start() */
+#define SVC_TMR_START      58
+/** @brief SVC number for swtimer_cancel() */
+#define SVC_TMR_CANCEL     59
+/** @brief SVC number for swtimer_wait() */
+#define SVC_TMR_WAIT       60
+/** @brief SVC number for sleep_until() */
+#define SVC_SLEEP_UNTIL    61
+/** @brief SVC number for sleep_for() */
+#define SVC_SLEEP_FOR      62
+/** @brief SVC number for get_time_us() */
+#define SVC_TIME_US        63
+/** @brief SVC number for thread_time_cycles() */
+#define SVC_THR_CYCLES     64
+/** @brief SVC number for thread_time_us() */
+#define SVC_THR_TIME_US    65
+/** @brief SVC number for uart_set_baud() */
+#define SVC_UART_BAUD      66
+/** @brief SVC number for deflog_register() */
+#define SVC_DEFLOG_REG     67
+/** @brief SVC number for trace_marker() */
+#define SVC_TRACE_MARKER   68
+/** @brief SVC number for sched_trace_dump() */
+#define SVC_SCHED_TRACE    69
+
 #endif /* _SVC_NUM_H_ */
@@ -15,10 +15,8 @@
 
 void *sys_sbrk(int incr);
 
-int sys_write(int file, char *ptr, int len);
-
-int sys_read(int file, char *ptr, int len);
-
 void sys_exit(int status);
 
+int sys_uart_set_baud(uint32_t baud);
+
 #endif /* _SYSCALLS_H_ */
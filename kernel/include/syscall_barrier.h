@@ -0,0 +1,103 @@
+/** @file syscall_barrier.h
+ *
+ *  @brief  Barriers and phase rendezvous for pipelines of periodic threads.
+ *          Both can be combined with the wait for the next period, so a
+ *          stage waits for its release and its upstream in one syscall.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_BARRIER_H_
+#define _SYSCALL_BARRIER_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+
+/** @brief Maximum number of barriers the kernel can hand out. */
+#define MAX_BARRIERS 8
+
+/** @brief Maximum number of phase objects the kernel can hand out. */
+#define MAX_PHASES 8
+
+/** @brief Flag: also wait for the caller's next period, must match 349_threads.h. */
+#define RENDEZVOUS_NEXT_PERIOD 0x1
+
+/** @brief Returned by sys_barrier_wait() to the thread that completed it. */
+#define BARRIER_LAST 1
+
+/**
+ * @brief      The struct for a barrier of a fixed number of threads.
+ */
+typedef struct {
+  uint32_t parties;            /** @brief threads needed to open the barrier */
+  volatile uint32_t arrived;   /** @brief threads waiting in the current round */
+  uint32_t index;              /** @brief index of the barrier in the global barrier array */
+  wait_queue_t waiters;        /** @brief threads waiting for the round to complete */
+} kbarrier_t;
+
+/**
+ * @brief      The struct for a phase counter that downstream stages wait on.
+ */
+typedef struct {
+  volatile uint32_t phase;     /** @brief number of completed phases */
+  uint32_t index;              /** @brief index of the phase in the global phase array */
+  wait_queue_t waiters;        /** @brief threads waiting for a phase, target in wait_mask */
+} kphase_t;
+
+/**
+ * @brief      Creates a barrier.
+ *
+ * @param[in]  parties  Number of threads that must arrive, at least 1.
+ *
+ * @return     A pointer to the barrier. NULL if none are left.
+ */
+kbarrier_t *sys_barrier_init( uint32_t parties );
+
+/**
+ * @brief      Arrives at a barrier and sleeps until every party has arrived.
+ *             All parties are released together and run in priority order
+ *             from the next scheduling point.
+ *
+ * @param[in]  barrier  The barrier.
+ * @param[in]  flags    RENDEZVOUS_NEXT_PERIOD to be released no earlier than
+ *                      the caller's next period, 0 otherwise.
+ *
+ * @return     BARRIER_LAST for the thread that completed the round, 0 for
+ *             the others, -1 if the caller may not block.
+ */
+int sys_barrier_wait( kbarrier_t *barrier, uint32_t flags );
+
+/**
+ * @brief      Creates a phase counter starting at 0.
+ *
+ * @return     A pointer to the phase. NULL if none are left.
+ */
+kphase_t *sys_phase_init( void );
+
+/**
+ * @brief      Completes a phase and releases the waiters that waited for
+ *             it. Never blocks, safe to call from ISRs.
+ *
+ * @param[in]  phase  The phase counter.
+ *
+ * @return     The new phase count.
+ */
+uint32_t sys_phase_signal( kphase_t *phase );
+
+/**
+ * @brief      Sleeps until the phase counter reaches target.
+ *
+ * @param[in]  phase   The phase counter.
+ * @param[in]  target  Phase count to wait for.
+ * @param[in]  flags   RENDEZVOUS_NEXT_PERIOD to be released no earlier than
+ *                     the caller's next period, 0 otherwise.
+ *
+ * @return     0 on success, -1 if the caller may not block.
+ */
+int sys_phase_wait( kphase_t *phase, uint32_t target, uint32_t flags );
+
+void initialize_barrier_array( void );
+
+#endif /* _SYSCALL_BARRIER_H_ */
@@ -0,0 +1,74 @@
+/** @file syscall_cond.h
+ *
+ *  @brief  Condition variables bound to an IPCP mutex. Waiting releases
+ *          the mutex and drops the waiter back to its remaining ceiling in
+ *          one step, and a woken waiter owns the mutex again before it
+ *          returns.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_COND_H_
+#define _SYSCALL_COND_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+#include <syscall_mutex.h>
+
+/** @brief Maximum number of condition variables the kernel can hand out. */
+#define MAX_CONDS 8
+
+/**
+ * @brief      The struct for a condition variable.
+ */
+typedef struct {
+  kmutex_t *mutex;        /** @brief the mutex protecting the predicate */
+  uint32_t index;         /** @brief index of the condition in the global array */
+  wait_queue_t waiters;   /** @brief threads waiting to be signalled */
+} kcond_t;
+
+/**
+ * @brief      Creates a condition variable bound to a mutex.
+ *
+ * @param[in]  mutex  The mutex every waiter holds.
+ *
+ * @return     A pointer to the condition variable. NULL if none are left.
+ */
+kcond_t *sys_cond_init( kmutex_t *mutex );
+
+/**
+ * @brief      Releases the mutex, sleeps until signalled and reacquires the
+ *             mutex.
+ *
+ * @param[in]  cond     The condition variable.
+ * @param[in]  timeout  Ticks to wait for a signal, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 when signalled, WAIT_TIMEOUT if no signal came in time, -1
+ *             on misuse. The mutex is held again in the first two cases.
+ */
+int sys_cond_wait( kcond_t *cond, uint32_t timeout );
+
+/**
+ * @brief      Wakes the highest priority waiter.
+ *
+ * @param[in]  cond  The condition variable.
+ *
+ * @return     Number of threads woken, 0 or 1.
+ */
+uint32_t sys_cond_signal( kcond_t *cond );
+
+/**
+ * @brief      Wakes every waiter.
+ *
+ * @param[in]  cond  The condition variable.
+ *
+ * @return     Number of threads woken.
+ */
+uint32_t sys_cond_broadcast( kcond_t *cond );
+
+void initialize_cond_array( void );
+
+#endif /* _SYSCALL_COND_H_ */
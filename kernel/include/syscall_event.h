@@ -0,0 +1,97 @@
+/** @file syscall_event.h
+ *
+ *  @brief  32-bit event flag groups that can be set from ISRs and waited on
+ *          by threads.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_EVENT_H_
+#define _SYSCALL_EVENT_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+
+/** @brief Maximum number of event groups the kernel can hand out. */
+#define MAX_EVENTS 16
+
+/** @brief Wait options, must match the values in 349_threads.h. */
+//@{
+#define EVENT_WAIT_ANY 0x0  /**< Wake when any bit of the mask is set. */
+#define EVENT_WAIT_ALL 0x1  /**< Wake when every bit of the mask is set. */
+#define EVENT_CLEAR    0x2  /**< Consume the matched bits on wakeup. */
+//@}
+
+/**
+ * @brief      The struct for an event flag group.
+ */
+typedef struct {
+  volatile uint32_t flags;  /** @brief currently set flags */
+  volatile uint32_t index;  /** @brief index of the group in the global event array*/
+  wait_queue_t waiters;     /** @brief threads sleeping in sys_event_wait() */
+} kevent_t;
+
+/**
+ * @brief      Creates an event flag group with every flag cleared.
+ *
+ * @return     A pointer to the group. NULL if no groups are left.
+ */
+kevent_t *sys_event_init( void );
+
+/**
+ * @brief      Waits until the flags in mask are set.
+ *
+ * @param[in]  event     The group to act on.
+ * @param[in]  mask      Flags to wait for, must not be 0.
+ * @param[in]  options   EVENT_WAIT_ANY or EVENT_WAIT_ALL, optionally or-ed
+ *                       with EVENT_CLEAR.
+ * @param[out] flags_out If not NULL, receives the flags that satisfied the
+ *                       wait (before they were cleared).
+ *
+ * @return     0 on success, -1 on bad arguments or if the thread may not
+ *             block.
+ */
+int sys_event_wait( kevent_t *event, uint32_t mask, uint32_t options,
+                    uint32_t *flags_out );
+
+/**
+ * @brief      Waits at most timeout ticks until the flags in mask are set.
+ *
+ * @param[in]  event     The group to act on.
+ * @param[in]  mask      Flags to wait for, must not be 0.
+ * @param[in]  options   Same as sys_event_wait().
+ * @param[out] flags_out Same as sys_event_wait().
+ * @param[in]  timeout   Ticks to wait, 0 to poll, WAIT_FOREVER for no limit.
+ *
+ * @return     0 on success, WAIT_TIMEOUT if the flags were not set in time,
+ *             -1 on bad arguments or if the thread may not block.
+ */
+int sys_event_wait_timed( kevent_t *event, uint32_t mask, uint32_t options,
+                          uint32_t *flags_out, uint32_t timeout );
+
+/**
+ * @brief      Sets flags and wakes every waiter whose condition now holds,
+ *             highest priority first. Safe to call from ISRs.
+ *
+ * @param[in]  event  The group to act on.
+ * @param[in]  mask   Flags to set.
+ *
+ * @return     The flags left set after the waiters were served.
+ */
+uint32_t sys_event_set( kevent_t *event, uint32_t mask );
+
+/**
+ * @brief      Clears flags.
+ *
+ * @param[in]  event  The group to act on.
+ * @param[in]  mask   Flags to clear.
+ *
+ * @return     The flags left set.
+ */
+uint32_t sys_event_clear( kevent_t *event, uint32_t mask );
+
+void initialize_event_array( void );
+
+#endif /* _SYSCALL_EVENT_H_ */
@@ -0,0 +1,91 @@
+/** @file syscall_fd.h
+ *
+ *  @brief  File descriptor table. Every descriptor points at the
+ *          operations of a device, so read() and write() cost a bounds
+ *          check and one indirect call on top of the device itself.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_FD_H_
+#define _SYSCALL_FD_H_
+
+#include <unistd.h>
+#include <fd_num.h>
+
+/** @brief The device is a terminal, isatty() reports it */
+#define FD_DEV_TTY 1
+
+/**
+ * @brief      Operations of a device. Operations a device does not support
+ *             return -1 rather than being NULL, so dispatch never checks.
+ */
+typedef struct {
+  int (*read)(char *buf, int len);         /**< Reads up to len bytes, 0 at end of file. */
+  int (*write)(const char *buf, int len);  /**< Writes len bytes, returns how many. */
+  uint32_t flags;                          /**< FD_DEV_TTY or 0. */
+} fd_dev_t;
+
+/**
+ * @brief      Writes to a file descriptor.
+ *
+ * @param      file  The file descriptor.
+ * @param      ptr   The bytes.
+ * @param      len   Number of bytes.
+ *
+ * @return     Number of bytes written, -1 if the descriptor is not open or
+ *             its device cannot be written.
+ */
+int sys_write( int file, char *ptr, int len );
+
+/**
+ * @brief      Reads from a file descriptor.
+ *
+ * @param      file  The file descriptor.
+ * @param      ptr   Where the bytes go.
+ * @param      len   Most bytes to read.
+ *
+ * @return     Number of bytes read, 0 at end of file, -1 if the descriptor
+ *             is not open or its device cannot be read.
+ */
+int sys_read( int file, char *ptr, int len );
+
+/**
+ * @brief      Unbinds a file descriptor from its device.
+ *
+ * @param      file  The file descriptor.
+ *
+ * @return     0 on success, -1 if it was not open.
+ */
+int sys_close( int file );
+
+/**
+ * @brief      Describes a file descriptor. Every device is a character
+ *             device.
+ *
+ * @param      file  The file descriptor.
+ * @param      st    A newlib struct stat.
+ *
+ * @return     0 on success, -1 if the descriptor is not open.
+ */
+int sys_fstat( int file, void *st );
+
+/**
+ * @brief      Whether a file descriptor is a terminal.
+ *
+ * @param      file  The file descriptor.
+ *
+ * @return     1 for the UART console, 0 otherwise.
+ */
+int sys_isatty( int file );
+
+/**
+ * @brief      Moves the file offset. No device is seekable.
+ *
+ * @return     -1 always.
+ */
+int sys_lseek( int file, int offset, int whence );
+
+#endif /* _SYSCALL_FD_H_ */
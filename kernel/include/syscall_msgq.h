@@ -0,0 +1,115 @@
+/** @file syscall_msgq.h
+ *
+ *  @brief  Zero-copy message queues of fixed-size blocks.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_MSGQ_H_
+#define _SYSCALL_MSGQ_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+
+/** @brief Maximum number of message queues the kernel can hand out. */
+#define MAX_MSGQS 8
+
+/** @brief Maximum number of blocks in one queue (one bit per block). */
+#define MSGQ_MAX_BLOCKS 32
+
+/**
+ * @brief      The struct for a message queue. The block storage is owned by
+ *             the user, the kernel only tracks which block is where, so a
+ *             message is never copied.
+ */
+typedef struct {
+  char *buffer;                       /** @brief user supplied block storage */
+  uint32_t block_size;                /** @brief size of one block in bytes */
+  uint32_t num_blocks;                /** @brief number of blocks in buffer */
+  uint32_t index;                     /** @brief index of the queue in the global queue array */
+
+  volatile uint32_t free_bitmap;      /** @brief blocks that can be reserved */
+  volatile uint32_t reserved_bitmap;  /** @brief blocks being filled by a sender */
+  volatile uint32_t borrowed_bitmap;  /** @brief blocks being read by a receiver */
+
+  uint8_t fifo[MSGQ_MAX_BLOCKS];      /** @brief committed blocks in send order */
+  volatile uint32_t fifo_head;        /** @brief index of the oldest committed block */
+  volatile uint32_t fifo_count;       /** @brief number of committed blocks */
+
+  volatile uint32_t high_water;       /** @brief most blocks ever out of the free pool */
+
+  wait_queue_t send_waiters;          /** @brief threads waiting for a free block */
+  wait_queue_t recv_waiters;          /** @brief threads waiting for a message */
+} kmsgq_t;
+
+/**
+ * @brief      Creates a message queue over user supplied storage.
+ *
+ * @param      buffer      Storage for num_blocks blocks of block_size bytes.
+ * @param      block_size  Size of one message block in bytes.
+ * @param      num_blocks  Number of blocks, at most MSGQ_MAX_BLOCKS.
+ *
+ * @return     A pointer to the queue. NULL if no queues are left or the
+ *             arguments are invalid.
+ */
+kmsgq_t *sys_msgq_init( void *buffer, uint32_t block_size, uint32_t num_blocks );
+
+/**
+ * @brief      Reserves a free block for the caller to fill in place.
+ *
+ * @param[in]  q        The queue to act on.
+ * @param[out] block    Receives the address of the block.
+ * @param[in]  timeout  Ticks to wait for a free block, 0 to poll or
+ *                      WAIT_FOREVER.
+ *
+ * @return     0 on success, WAIT_TIMEOUT on timeout, -1 on failure.
+ */
+int sys_msgq_reserve( kmsgq_t *q, void **block, uint32_t timeout );
+
+/**
+ * @brief      Publishes a reserved block to the receivers.
+ *
+ * @param[in]  q      The queue to act on.
+ * @param[in]  block  A block returned by sys_msgq_reserve().
+ *
+ * @return     0 on success, -1 if the block was not reserved.
+ */
+int sys_msgq_commit( kmsgq_t *q, void *block );
+
+/**
+ * @brief      Borrows the oldest committed block.
+ *
+ * @param[in]  q        The queue to act on.
+ * @param[out] block    Receives the address of the block.
+ * @param[in]  timeout  Ticks to wait for a message, 0 to poll or
+ *                      WAIT_FOREVER.
+ *
+ * @return     0 on success, WAIT_TIMEOUT on timeout, -1 on failure.
+ */
+int sys_msgq_receive( kmsgq_t *q, void **block, uint32_t timeout );
+
+/**
+ * @brief      Returns a borrowed block to the free pool.
+ *
+ * @param[in]  q      The queue to act on.
+ * @param[in]  block  A block returned by sys_msgq_receive().
+ *
+ * @return     0 on success, -1 if the block was not borrowed.
+ */
+int sys_msgq_release( kmsgq_t *q, void *block );
+
+/**
+ * @brief      Largest number of blocks that were ever reserved, queued or
+ *             borrowed at the same time.
+ *
+ * @param[in]  q      The queue to act on.
+ *
+ * @return     The high-water mark in blocks.
+ */
+uint32_t sys_msgq_high_water( kmsgq_t *q );
+
+void initialize_msgq_array( void );
+
+#endif /* _SYSCALL_MSGQ_H_ */
@@ -11,6 +11,14 @@
 #define _SYSCALL_MUTEX_H_
 
 #include <unistd.h>
+#include <wait_queue.h>
+#include <mutex_profile.h>
+
+/** @brief Owner of a mutex that nobody holds. */
+#define NOT_LOCKED 0xFFFFFFFF
+
+/** @brief Returned by a lock that would close a cycle of waiting threads. */
+#define MUTEX_DEADLOCK (-3)
 /**
  * @brief      The struct for a mutex.
  */
@@ -18,6 +26,13 @@ typedef struct {
   volatile uint32_t locked_by;  /** @brief which thread the mutex is locked by, or NOT_LOCKED if unlocked*/
   volatile uint32_t prio_ceil;  /** @brief priority ceil of the mutex*/ 
   volatile uint32_t index;      /** @brief index of the mutex in the global mutex array*/
+  wait_queue_t waiters;         /** @brief threads sleeping until the mutex is handed to them */
+  volatile uint32_t locked_at;  /** @brief tick at which the current owner got the mutex */
+  uint32_t cs_length[16];       /** @brief declared longest critical section per thread, 0 if undeclared */
+  volatile uint32_t cs_overruns; /** @brief unlocks that exceeded the declared length */
+#if MUTEX_PROFILING
+  mutex_profile_t profile;      /** @brief contention and hold time counters */
+#endif
 } kmutex_t;
 
 
@@ -38,12 +53,41 @@ kmutex_t *sys_mutex_init( uint32_t max_prio );
  * @brief      Lock a mutex
  *
  *             This function will not return until the current thread has
- *             obtained the mutex.
+ *             obtained the mutex. Under DEADLOCK_FAIL_LOCK, a lock that
+ *             would deadlock kills the current thread instead.
  *
  * @param[in]  mutex  The mutex to act on.
  */
 void sys_mutex_lock( kmutex_t *mutex );
 
+/**
+ * @brief      Declare the longest critical section a thread runs on a mutex.
+ *
+ *             The kernel adds the resulting IPCP blocking terms to the UB test
+ *             and warns at unlock time when a declared length is exceeded.
+ *
+ * @param[in]  mutex     The mutex to act on.
+ * @param[in]  prio      The thread that locks the mutex.
+ * @param[in]  cs_ticks  Longest hold time in ticks.
+ *
+ * @return     0 on success, -1 on invalid arguments or if the thread set
+ *             would no longer pass the UB test.
+ */
+int sys_mutex_declare( kmutex_t *mutex, uint32_t prio, uint32_t cs_ticks );
+
+/**
+ * @brief      Lock a mutex, giving up after timeout ticks
+ *
+ * @param[in]  mutex    The mutex to act on.
+ * @param[in]  timeout  Ticks to wait, 0 to try once, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 once the mutex is held, WAIT_TIMEOUT if it was not obtained
+ *             in time, MUTEX_DEADLOCK if waiting would deadlock (see
+ *             kernel_config.h), -1 on misuse.
+ */
+int sys_mutex_lock_timed( kmutex_t *mutex, uint32_t timeout );
+
 /**
  * @brief      Unlock a mutex
  *
@@ -51,6 +95,32 @@ void sys_mutex_lock( kmutex_t *mutex );
  */
 void sys_mutex_unlock( kmutex_t *mutex );
 
+/**
+ * @brief      Print the contention and hold time counters of every mutex.
+ *
+ * @return     0 on success, -1 if the kernel was built without
+ *             MUTEX_PROFILING.
+ */
+int sys_mutex_profile_dump( void );
+
+/**
+ * @brief      Kernel internal: makes thread the owner of an unlocked mutex
+ *             and raises it to the ceiling. Call with interrupts disabled.
+ *
+ * @param[in]  mutex   The mutex.
+ * @param[in]  thread  The new owner.
+ */
+void mutex_take( kmutex_t *mutex, uint32_t thread );
+
+/**
+ * @brief      Kernel internal: hands the mutex to the highest priority
+ *             waiter or unlocks it. Call with interrupts disabled. The old
+ *             owner's held bitmap and priority are left to the caller.
+ *
+ * @param[in]  mutex  The mutex.
+ */
+void mutex_give( kmutex_t *mutex );
+
 void initialize_mutex_array( void );
 
 #endif /* _SYSCALL_MUTEX_H_ */
@@ -0,0 +1,122 @@
+/** @file syscall_rwlock.h
+ *
+ *  @brief  Reader-writer locks under the immediate priority ceiling
+ *          protocol. Readers are raised to the read ceiling, the highest
+ *          priority of any writer, so concurrent readers above it never
+ *          block each other. Writers are raised to the write ceiling, the
+ *          highest priority of any user.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_RWLOCK_H_
+#define _SYSCALL_RWLOCK_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+
+/** @brief Maximum number of reader-writer locks the kernel can hand out. */
+#define MAX_RWLOCKS 8
+
+/**
+ * @brief      The struct for a reader-writer lock.
+ */
+typedef struct {
+  volatile uint32_t writer;          /** @brief thread holding the write lock, or RWLOCK_FREE */
+  volatile uint32_t readers;         /** @brief bitmap of threads holding the read lock */
+  uint32_t read_ceil;                /** @brief priority of the highest priority writer */
+  uint32_t write_ceil;               /** @brief priority of the highest priority user */
+  uint32_t index;                    /** @brief index of the lock in the global rwlock array */
+  uint32_t read_cs_length[16];       /** @brief declared longest read section per thread */
+  uint32_t write_cs_length[16];      /** @brief declared longest write section per thread */
+  wait_queue_t read_waiters;         /** @brief threads waiting to read */
+  wait_queue_t write_waiters;        /** @brief threads waiting to write */
+} krwlock_t;
+
+/**
+ * @brief      Creates a reader-writer lock.
+ *
+ * @param      read_ceil   Priority of the highest priority thread that
+ *                         writes.
+ * @param      write_ceil  Priority of the highest priority thread that reads
+ *                         or writes, at most read_ceil.
+ *
+ * @return     A pointer to the lock. NULL if none are left or the ceilings
+ *             are inconsistent.
+ */
+krwlock_t *sys_rwlock_init( uint32_t read_ceil, uint32_t write_ceil );
+
+/**
+ * @brief      Takes the lock for reading, sleeping while a writer holds it.
+ *
+ * @param[in]  rw       The lock.
+ * @param[in]  timeout  Ticks to wait, 0 to try once, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 on success, WAIT_TIMEOUT if the lock was not obtained in
+ *             time, -1 on misuse.
+ */
+int sys_rwlock_read_lock( krwlock_t *rw, uint32_t timeout );
+
+/**
+ * @brief      Takes the lock for writing, sleeping while anybody holds it.
+ *
+ * @param[in]  rw       The lock.
+ * @param[in]  timeout  Ticks to wait, 0 to try once, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 on success, WAIT_TIMEOUT if the lock was not obtained in
+ *             time, -1 on misuse.
+ */
+int sys_rwlock_write_lock( krwlock_t *rw, uint32_t timeout );
+
+/**
+ * @brief      Releases the read or write hold of the calling thread.
+ *
+ * @param[in]  rw    The lock.
+ *
+ * @return     0 on success, -1 if the caller does not hold the lock.
+ */
+int sys_rwlock_unlock( krwlock_t *rw );
+
+/**
+ * @brief      Declares the longest read and write sections of a thread, for
+ *             the blocking term of the UB test.
+ *
+ * @param[in]  rw           The lock.
+ * @param[in]  prio         The thread.
+ * @param[in]  read_ticks   Longest read section, 0 if it never reads.
+ * @param[in]  write_ticks  Longest write section, 0 if it never writes.
+ *
+ * @return     0 on success, -1 on invalid arguments or if the thread set
+ *             would fail the UB test.
+ */
+int sys_rwlock_declare( krwlock_t *rw, uint32_t prio, uint32_t read_ticks,
+                        uint32_t write_ticks );
+
+/**
+ * @brief      Highest ceiling among the reader-writer locks a thread holds.
+ *
+ * @param[in]  thread    The thread.
+ * @param[in]  priority  Priority to start from.
+ *
+ * @return     The smaller of priority and the held ceilings.
+ */
+uint32_t rwlock_held_ceiling( uint32_t thread, uint32_t priority );
+
+/**
+ * @brief      Longest declared reader-writer lock section of the given lower
+ *             priority threads that can block thread index.
+ *
+ * @param[in]  index  The thread that may be blocked.
+ * @param[in]  lower  Bitmap of the lower priority threads that exist.
+ *
+ * @return     The blocking term contributed by reader-writer locks.
+ */
+uint32_t rwlock_blocking_term( uint32_t index, uint32_t lower );
+
+void initialize_rwlock_array( void );
+
+#endif /* _SYSCALL_RWLOCK_H_ */
@@ -0,0 +1,83 @@
+/** @file syscall_sem.h
+ *
+ *  @brief  Counting semaphores that can be posted from ISRs and waited on
+ *          by threads.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_SEM_H_
+#define _SYSCALL_SEM_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+
+/** @brief Maximum number of semaphores the kernel can hand out. */
+#define MAX_SEMAPHORES 16
+
+/**
+ * @brief      The struct for a counting semaphore.
+ */
+typedef struct {
+  volatile uint32_t count;      /** @brief number of available units */
+  volatile uint32_t max_count;  /** @brief count at which posts start failing */
+  volatile uint32_t index;      /** @brief index of the semaphore in the global semaphore array*/
+  wait_queue_t waiters;         /** @brief threads sleeping in sys_sem_wait() */
+} ksem_t;
+
+/**
+ * @brief      Creates a semaphore.
+ *
+ * @param      count      Initial number of units.
+ * @param      max_count  Largest value the count may reach.
+ *
+ * @return     A pointer to the semaphore. NULL if no semaphores are left or
+ *             the counts are invalid.
+ */
+ksem_t *sys_sem_init( uint32_t count, uint32_t max_count );
+
+/**
+ * @brief      Takes one unit, sleeping until one is available.
+ *
+ * @param[in]  sem   The semaphore to act on.
+ *
+ * @return     0 on success, -1 if the calling thread may not block.
+ */
+int sys_sem_wait( ksem_t *sem );
+
+/**
+ * @brief      Takes one unit, sleeping at most timeout ticks for one to
+ *             become available.
+ *
+ * @param[in]  sem      The semaphore to act on.
+ * @param[in]  timeout  Ticks to wait, 0 to poll, WAIT_FOREVER for no limit.
+ *
+ * @return     0 on success, WAIT_TIMEOUT if no unit arrived in time, -1 if
+ *             the calling thread may not block.
+ */
+int sys_sem_wait_timed( ksem_t *sem, uint32_t timeout );
+
+/**
+ * @brief      Takes one unit if one is available without blocking.
+ *
+ * @param[in]  sem   The semaphore to act on.
+ *
+ * @return     0 on success, -1 if the count was 0.
+ */
+int sys_sem_try_wait( ksem_t *sem );
+
+/**
+ * @brief      Releases one unit, handing it directly to the highest priority
+ *             waiter if there is one. Safe to call from ISRs.
+ *
+ * @param[in]  sem   The semaphore to act on.
+ *
+ * @return     0 on success, -1 if the count is already at max_count.
+ */
+int sys_sem_post( ksem_t *sem );
+
+void initialize_sem_array( void );
+
+#endif /* _SYSCALL_SEM_H_ */
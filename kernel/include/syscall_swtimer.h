@@ -0,0 +1,126 @@
+/** @file syscall_swtimer.h
+ *
+ *  @brief  Software timers on a hashed timer wheel driven by SysTick.
+ *
+ *          A timer lives in slot (expiry % SWTIMER_WHEEL_SLOTS) on a doubly
+ *          linked list, so arming and cancelling are O(1). Each tick only
+ *          looks at one slot, and timers that expire in a later turn of the
+ *          wheel are skipped.
+ *
+ *          On expiry a timer does one of three things: it wakes the threads
+ *          blocked in sys_swtimer_wait(), it sets flags on an event, or it
+ *          runs a kernel callback. Callbacks run from SysTick, so they must
+ *          be short and must never block. They are not available to user
+ *          code, since they run privileged.
+ *
+ *  @date   October 18 2026
+ *
+ *  @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _SYSCALL_SWTIMER_H_
+#define _SYSCALL_SWTIMER_H_
+
+#include <unistd.h>
+#include <wait_queue.h>
+#include <syscall_event.h>
+
+/** @brief Maximum number of software timers. */
+#define MAX_SWTIMERS 16
+
+/** @brief Slots in the timer wheel, a power of two. */
+#define SWTIMER_WHEEL_SLOTS 64
+
+/** @brief What a timer does when it expires. */
+//@{
+#define SWTIMER_WAKE     0
+#define SWTIMER_EVENT    1
+#define SWTIMER_CALLBACK 2
+//@}
+
+/** @brief Kernel callback run when a SWTIMER_CALLBACK timer expires. */
+typedef void (*swtimer_fn_t)( void *arg );
+
+/**
+ * @brief      The struct for a software timer.
+ */
+typedef struct kswtimer {
+  struct kswtimer *next;        /** @brief next timer in the same wheel slot */
+  struct kswtimer *prev;        /** @brief previous timer in the same wheel slot */
+  struct kswtimer *fire_next;   /** @brief next timer expiring in this tick */
+  uint32_t expiry;              /** @brief tick at which the timer fires */
+  uint32_t period;              /** @brief ticks between firings, 0 for one-shot */
+  uint32_t armed;               /** @brief 1 while the timer is on the wheel */
+  uint32_t target;              /** @brief SWTIMER_WAKE, _EVENT or _CALLBACK */
+  uint32_t index;               /** @brief index of the timer in the global array */
+  volatile uint32_t pending;    /** @brief SWTIMER_WAKE: expirations nobody waited for yet */
+  kevent_t *event;              /** @brief SWTIMER_EVENT: event to set */
+  uint32_t mask;                /** @brief SWTIMER_EVENT: flags to set */
+  swtimer_fn_t fn;              /** @brief SWTIMER_CALLBACK: function to run */
+  void *arg;                    /** @brief SWTIMER_CALLBACK: argument for fn */
+  wait_queue_t waiters;         /** @brief SWTIMER_WAKE: threads in sys_swtimer_wait() */
+} kswtimer_t;
+
+/**
+ * @brief      Creates a timer that wakes threads or sets event flags.
+ *
+ * @param[in]  event  Event to set on expiry, or NULL to wake the threads
+ *                    waiting in sys_swtimer_wait().
+ * @param[in]  mask   Flags to set on the event.
+ *
+ * @return     A pointer to the timer. NULL if none are left.
+ */
+kswtimer_t *sys_swtimer_create( kevent_t *event, uint32_t mask );
+
+/**
+ * @brief      Creates a timer that runs a kernel callback from SysTick.
+ *
+ * @param[in]  fn   Function to run, short and non-blocking.
+ * @param[in]  arg  Argument for fn.
+ *
+ * @return     A pointer to the timer. NULL if none are left.
+ */
+kswtimer_t *swtimer_create_callback( swtimer_fn_t fn, void *arg );
+
+/**
+ * @brief      Arms a timer, re-arming it if it is already armed.
+ *
+ * @param[in]  timer   The timer.
+ * @param[in]  delay   Ticks until the first expiry, at least 1.
+ * @param[in]  period  Ticks between later expiries, 0 for one-shot.
+ *
+ * @return     0 on success, -1 on invalid arguments.
+ */
+int sys_swtimer_start( kswtimer_t *timer, uint32_t delay, uint32_t period );
+
+/**
+ * @brief      Disarms a timer. Pending expirations are dropped.
+ *
+ * @param[in]  timer  The timer.
+ *
+ * @return     1 if the timer was armed, 0 otherwise.
+ */
+int sys_swtimer_cancel( kswtimer_t *timer );
+
+/**
+ * @brief      Sleeps until a SWTIMER_WAKE timer expires. Returns at once if
+ *             it expired since the last wait.
+ *
+ * @param[in]  timer    The timer.
+ * @param[in]  timeout  Ticks to wait, 0 to poll, WAIT_FOREVER for no limit.
+ *
+ * @return     Number of expirations consumed, WAIT_TIMEOUT if none came in
+ *             time, -1 on misuse.
+ */
+int sys_swtimer_wait( kswtimer_t *timer, uint32_t timeout );
+
+/**
+ * @brief      Fires the timers expiring at now. Called from SysTick.
+ *
+ * @param[in]  now  The current tick count.
+ */
+void swtimer_tick( uint32_t now );
+
+void initialize_swtimer_array( void );
+
+#endif /* _SYSCALL_SWTIMER_H_ */
@@ -12,6 +12,97 @@
 
 #include <unistd.h>
 
+/**
+ * @struct global_threads_info_t
+ * @brief Global thread information for tracking timing, priorities, and stack limits.
+ */
+typedef struct global_threads_info
+{
+    uint32_t max_threads;   /**< Maximum number of threads. */
+    uint32_t max_mutexes;   /**< Maximum number of mutexes. */
+    uint32_t stack_size;    /**< Size of stack in words. */
+    uint32_t tick_counter;  /**< System tick counter. */
+    uint32_t current_thread;  /**< Index of the currently running thread. */
+
+    uint32_t thread_time_left_in_C[16]; /**< Remaining computation time for each thread. */
+    uint32_t thread_time_left_in_T[16]; /**< Remaining period time for each thread. */
+    uint64_t thread_cycles[16]; /**< CPU cycles each thread ran, charged at every context switch. */
+    uint64_t release_cycles[16]; /**< thread_cycles at the start of each thread's current period. */
+    uint32_t switch_cycles; /**< DWT cycle count at the last context switch. */
+    uint32_t cycles_per_tick; /**< Processor cycles per scheduler tick. */
+
+    uint32_t ready_threads[16];  /**< Array of ready threads. */
+    uint32_t waiting_threads[16]; /**< Array of waiting threads. */
+    uint32_t mutex_index;
+} global_threads_info_t;
+
+/**
+ * @enum thread_state_t
+ * @brief Enumeration of thread states.
+ */
+typedef enum thread_state{
+    NEW, //process created
+    READY, //process ready to run
+    RUNNING, //process running
+    WAITING, //process waiting for event
+    DONE, //Exit
+    BLOCKED, //process blocked by mutex
+    SUSPENDED //process sleeping on a kernel wait queue
+} thread_state_t;
+
+/**
+ * @struct pushed_callee_stack_frame
+ * @brief Stack frame pushed onto MSP before initiating a context switch.
+ */
+typedef struct {
+    uint32_t *PSP;   /**< Pointer to the thread's Process Stack Pointer (PSP). */
+    uint32_t r4;    /**< Register value for r4 */
+    uint32_t r5;    /**< General-purpose register R5. */
+    uint32_t r6;    /**< General-purpose register R6. */
+    uint32_t r7;    /**< General-purpose register R7. */
+    uint32_t r8;    /**< General-purpose register R8. */
+    uint32_t r9;    /**< General-purpose register R9. */
+    uint32_t r10;   /**< General-purpose register R10. */
+    uint32_t r11;   /**< General-purpose register R11. */
+    uint32_t lr;    /**< Link register (LR). */
+} pushed_callee_stack_frame;
+
+/**
+ * @struct TCB_t
+ * @brief Thread Control Block (TCB) structure.
+ *
+ * This structure holds the context and metadata for a thread, including
+ * its stack pointer, priority, computation time, period, and state.
+ */
+typedef struct TCB{
+    pushed_callee_stack_frame *msp;   /**< Pointer to the thread's kernel stack. */
+
+    uint32_t priority;                /**< Dynamic Thread priority (0-16). */
+    uint32_t computation_time;        /**< Computation time (C) in ticks. */
+    uint32_t period;                  /**< Period (T) in ticks. */
+    uint32_t svc_status;              /**< SVC status (privileged/unprivileged). */
+
+    thread_state_t state;             /**< Current state of the thread. */
+
+    uint32_t held_mutex_bitmap; /**< Bitmap of held mutexes. */
+    uint32_t waiting_mutex_bitmap; /**< Bitmap of waiting mutexes. */
+
+    int32_t wait_status;    /**< Status handed over by whoever woke the thread. */
+    uint32_t wait_mask;     /**< Object specific wait argument (e.g. event flags). */
+    uint32_t wait_options;  /**< Object specific wait options. */
+    void *wait_queue;       /**< Wait queue the thread is SUSPENDED on. */
+    uint32_t wait_deadline; /**< Tick at which a timed wait expires. */
+    volatile uint32_t wait_period; /**< Set while a rendezvous waiter also waits for its next period. */
+
+    uint8_t processed; /**< Flag indicating if the thread has been processed in current period. */
+} TCB_t;
+
+/** @brief Array of Thread Control Blocks (TCBs) for all threads. */
+extern TCB_t TCB_ARRAY[16];
+
+/** @brief Global structure holding thread-related information. */
+extern global_threads_info_t global_threads_info;
+
 
 /**
  * @brief      The PendSV interrupt handler.
@@ -117,6 +208,14 @@ void sys_thread_kill( void );
  */
 uint32_t sys_get_time( void );
 
+/**
+ * @brief      Get the monotonic time with microsecond resolution. It does
+ *             not wrap, unlike the 32-bit tick count.
+ *
+ * @return     The time in microseconds since the scheduler started.
+ */
+uint64_t sys_get_time_us( void );
+
 /**
  * @brief      Get the effective priority of the current running thread
  *
@@ -132,11 +231,46 @@ uint32_t sys_get_priority( void );
  */
 uint32_t sys_thread_time( void );
 
+/**
+ * @brief      Gets the CPU time of the current thread in processor cycles,
+ *             measured at every context switch.
+ *
+ * @return     Cycles the thread ran since it was created.
+ */
+uint64_t sys_thread_time_cycles( void );
+
+/**
+ * @brief      Gets the CPU time of the current thread in microseconds.
+ *
+ * @return     Microseconds the thread ran since it was created.
+ */
+uint64_t sys_thread_time_us( void );
+
 /**
  * @brief      Waits efficiently by descheduling thread.
  */
 void sys_wait_until_next_period( void );
 
+/**
+ * @brief      Deschedules the current thread until an absolute tick.
+ *
+ * @param[in]  tick  Tick to wake up at. Returns at once if it has passed.
+ *
+ * @return     0 once the tick is reached, -1 if the caller may not sleep,
+ *             the wake status if the sleep was cut short.
+ */
+int sys_sleep_until( uint32_t tick );
+
+/**
+ * @brief      Deschedules the current thread for a number of ticks.
+ *
+ * @param[in]  ticks  Ticks to sleep, 0 returns at once.
+ *
+ * @return     0 once the time is up, -1 if the caller may not sleep,
+ *             the wake status if the sleep was cut short.
+ */
+int sys_sleep_for( uint32_t ticks );
+
 /**
 * @brief      Kills current running thread. Aborts program if current thread is
 *             main thread or the idle thread or if current thread exited
@@ -146,6 +280,25 @@ void sys_wait_until_next_period( void );
 */
 void sys_thread_kill( void );
 
+/**
+* @brief      Utilization bound test with IPCP blocking terms.
+*
+* @param[in]  prio  Index of a thread about to be created, -1 for none.
+* @param[in]  C     Computation time of that thread.
+* @param[in]  T     Period of that thread.
+*
+* @return     0 if the thread set is schedulable, -1 otherwise.
+*/
+int ub_test( int prio, int C, int T );
+
+/**
+* @brief      Recomputes a thread's dynamic priority from the ceilings of the
+*             mutexes and reader-writer locks it still holds.
+*
+* @param[in]  thread  The thread.
+*/
+void thread_update_priority( uint32_t thread );
+
 void systick_c_handler();
 
 #endif /* _SYSCALL_THREAD_H_ */
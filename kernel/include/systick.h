@@ -22,5 +22,16 @@ void systick_delay();
 
 uint32_t systick_get_ticks();
 
+/**
+ * @brief  Processor cycles since systick_init(), as a 64-bit count that
+ *         does not wrap. Safe to call from any context.
+ */
+uint64_t systick_get_cycles();
+
+/**
+ * @brief  Microseconds since systick_init(). Safe to call from any context.
+ */
+uint64_t systick_get_time_us();
+
 void clear_systick_flag();
 #endif /* _SYSTICK_H_ */
@@ -13,12 +13,29 @@
 
 #include <unistd.h>
 
+/** @brief Baud rate used when uart_init() gets none */
+#define UART_DEFAULT_BAUD 115200
+
 void uart_init(int baud);
 
+int uart_set_baud_rate(uint32_t baud);
+
+void uart_tx_poll();
+
 int uart_put_byte(char c);
 
+int uart_write(const char *buf, int len);
+
+int uart_write_record(const char *buf, int len);
+
 int uart_get_byte(char *c);
 
+int uart_read(char *buf, int len);
+
+int uart_wait_readable();
+
+int uart_wait_writable();
+
 void uart_flush();
 
 #endif /* _UART_H_ */
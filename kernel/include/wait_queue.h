@@ -0,0 +1,114 @@
+/**
+ * @file   wait_queue.h
+ *
+ * @brief  Priority ordered wait queues shared by the kernel blocking
+ *         primitives (semaphores, event flags, ...).
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#ifndef _WAIT_QUEUE_H_
+#define _WAIT_QUEUE_H_
+
+#include <unistd.h>
+
+/** @brief Wait status handed to a thread that was woken normally. */
+#define WAIT_OK 0
+
+/** @brief Wait status handed to a thread whose timeout expired. */
+#define WAIT_TIMEOUT (-2)
+
+/** @brief Timeout value that never expires. */
+#define WAIT_FOREVER 0xFFFFFFFF
+
+/**
+ * @brief      A wait queue is a bitmap of the threads sleeping on it. Bit i
+ *             is thread i, and since a thread's index is its static priority
+ *             the lowest set bit is always the highest priority waiter.
+ */
+typedef struct {
+  volatile uint32_t waiters;  /** @brief bitmap of sleeping threads */
+} wait_queue_t;
+
+/**
+ * @brief      Empties a wait queue.
+ *
+ * @param[in]  wq    The wait queue.
+ */
+void wait_queue_init( wait_queue_t *wq );
+
+/**
+ * @brief      Marks the current thread SUSPENDED on the wait queue. Must be
+ *             called with interrupts disabled so that the check of the
+ *             object state and the enqueue are atomic with respect to ISRs.
+ *
+ * @param[in]  wq       The wait queue.
+ * @param[in]  timeout  Ticks after which the thread is woken with
+ *                      WAIT_TIMEOUT, or WAIT_FOREVER.
+ *
+ * @return     0 if the thread was enqueued, WAIT_TIMEOUT if timeout is 0,
+ *             -1 if the caller is the idle or default thread and is not
+ *             allowed to sleep.
+ */
+int wait_queue_enqueue( wait_queue_t *wq, uint32_t timeout );
+
+/**
+ * @brief      Gives up the CPU after wait_queue_enqueue() and interrupts have
+ *             been restored. Returns once somebody woke the thread.
+ *
+ * @return     The status passed to the waking call.
+ */
+int32_t wait_queue_sleep( void );
+
+/**
+ * @brief      Wakes the highest priority waiter. Safe to call from ISRs.
+ *
+ * @param[in]  wq      The wait queue.
+ * @param[in]  status  Value returned from the waiter's wait_queue_sleep().
+ *
+ * @return     Index of the woken thread or -1 if the queue was empty.
+ */
+int wait_queue_wake_one( wait_queue_t *wq, int32_t status );
+
+/**
+ * @brief      Wakes a specific waiter. Safe to call from ISRs.
+ *
+ * @param[in]  wq      The wait queue.
+ * @param[in]  thread  Index of the thread to wake.
+ * @param[in]  status  Value returned from the waiter's wait_queue_sleep().
+ */
+void wait_queue_wake_thread( wait_queue_t *wq, uint32_t thread, int32_t status );
+
+/**
+ * @brief      Wakes every waiter. Safe to call from ISRs.
+ *
+ * @param[in]  wq      The wait queue.
+ * @param[in]  status  Value returned from each waiter's wait_queue_sleep().
+ *
+ * @return     Number of threads woken.
+ */
+uint32_t wait_queue_wake_all( wait_queue_t *wq, int32_t status );
+
+/**
+ * @brief      Moves a sleeping thread to another wait queue, dropping its
+ *             timeout. Safe to call from ISRs.
+ *
+ * @param[in]  from    The wait queue the thread sleeps on.
+ * @param[in]  to      The wait queue to move it to.
+ * @param[in]  thread  Index of the thread to move.
+ *
+ * @return     0 on success, -1 if the thread was not sleeping on from.
+ */
+int wait_queue_move( wait_queue_t *from, wait_queue_t *to, uint32_t thread );
+
+/**
+ * @brief      Wakes every timed waiter whose deadline has passed with
+ *             WAIT_TIMEOUT. Called from the SysTick handler.
+ *
+ * @param[in]  now   The current tick count.
+ */
+void wait_queue_tick( uint32_t now );
+
+#endif /* _WAIT_QUEUE_H_ */
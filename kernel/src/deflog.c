@@ -0,0 +1,220 @@
+/**
+ * @file   deflog.c
+ *
+ * @brief  Kernel side of deferred logging. Holds the kernel log ring and
+ *         the ring registered by user code, and hands their records to the
+ *         UART driver, which sends them whenever no text is queued.
+ *
+ *         Records leave the rings whole: once the first byte of a record
+ *         was sent, the rest goes before anything else, so the host decoder
+ *         never sees text in the middle of a record.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <klog.h>
+#include <arm.h>
+#include <uart.h>
+#include <syscall_thread.h>
+
+/** @brief Size of the kernel log ring, must be a power of two. */
+#define KLOG_RING_SIZE 512
+
+/** @brief Storage for the kernel log ring. */
+static uint8_t klog_data[KLOG_RING_SIZE];
+
+/**
+ * @brief Ring of the records logged by the kernel. Initialized statically,
+ *        so klog() works before anything else is set up.
+ */
+ring_buffer_t klog_ring = { klog_data, KLOG_RING_SIZE - 1, 0, 0, 0, 0 };
+
+/** @brief Ring of the records logged by user code, NULL if none. */
+static ring_buffer_t *user_ring;
+
+/** @brief Ring the bytes of the last deflog_peek() came from. */
+static ring_buffer_t *deflog_source;
+
+/** @brief Bytes of the record on the wire not sent yet, 0 between records. */
+static uint32_t deflog_left;
+
+/**
+ * @brief Forgets the user ring. Records klog() queued before are kept.
+ */
+void klog_init(){
+  user_ring = NULL;
+  deflog_source = NULL;
+  deflog_left = 0;
+}
+
+/**
+ * @brief Queues text in the kernel log ring, DEFLOG_MAX_ARGS words at a
+ *        time. When the ring is full, threads sleep a tick at a time and
+ *        the default thread, which may not sleep, polls.
+ *
+ * @param[in] buf The text.
+ * @param[in] len Number of bytes.
+ * @return len.
+ */
+int klog_write(const char *buf, int len){
+  uint32_t args[DEFLOG_MAX_ARGS];
+  int i = 0;
+
+  while (i < len){
+    uint32_t n = len - i;
+    if (n > 4 * DEFLOG_MAX_ARGS){
+      n = 4 * DEFLOG_MAX_ARGS;
+    }
+
+    uint32_t nargs = (n + 3) / 4;
+    for (uint32_t k = 0; k < nargs; k++){
+      args[k] = 0;
+    }
+    for (uint32_t k = 0; k < n; k++){
+      args[k / 4] |= (uint32_t)(uint8_t)buf[i + k] << (8 * (k % 4));
+    }
+
+    while (deflog_write(&klog_ring, DEFLOG_ID_TEXT, args, nargs) < 0){
+      uart_tx_poll();
+      sys_sleep_for(1);
+    }
+    i += n;
+  }
+  return len;
+}
+
+/**
+ * @brief Length of the record starting at a free running index. The user
+ *        ring is user memory, so a broken argument count is clamped.
+ *
+ * @param[in] rb The ring.
+ * @param[in] pos Index of the record's first byte.
+ * @return Size of the record in bytes.
+ */
+static uint32_t deflog_record_len(ring_buffer_t *rb, uint32_t pos){
+  uint32_t nargs = rb->data[(pos + 1) & rb->mask];
+  if (nargs > DEFLOG_MAX_ARGS){
+    nargs = DEFLOG_MAX_ARGS;
+  }
+  return DEFLOG_RECORD_SIZE(nargs);
+}
+
+/**
+ * @brief Picks the ring to send from next, kernel records first.
+ *
+ * @return The ring, NULL if both are empty.
+ */
+static ring_buffer_t *deflog_next_ring(){
+  if (ring_count(&klog_ring) != 0){
+    return &klog_ring;
+  }
+  if (user_ring != NULL && ring_count(user_ring) != 0){
+    return user_ring;
+  }
+  return NULL;
+}
+
+/**
+ * @brief Whether any log ring has records to send.
+ *
+ * @return 1 if there is something to send, 0 otherwise.
+ */
+int deflog_pending(){
+  return deflog_left != 0 || deflog_next_ring() != NULL;
+}
+
+/**
+ * @brief Whether a record has been partly sent.
+ *
+ * @return 1 if the rest of a record has to go out first, 0 otherwise.
+ */
+int deflog_in_record(){
+  return deflog_left != 0;
+}
+
+/**
+ * @brief Next bytes to send, cut after the last whole record that fits.
+ *
+ * @param[out] data Where the bytes start.
+ * @param[in] max Most bytes wanted.
+ * @return Number of bytes, 0 if there is nothing to send.
+ */
+uint32_t deflog_peek(const uint8_t **data, uint32_t max){
+  ring_buffer_t *rb = deflog_left != 0 ? deflog_source : deflog_next_ring();
+  if (rb == NULL){
+    return 0;
+  }
+  deflog_source = rb;
+
+  uint32_t offset;
+  uint32_t n = ring_peek_contiguous(rb, &offset);
+  if (n > max){
+    n = max;
+  }
+  *data = &rb->data[offset];
+
+  /* Records are committed whole, so every record start below n is readable */
+  uint32_t tail = rb->tail;
+  uint32_t len = deflog_left;
+  uint32_t whole = 0;
+  while (whole < n){
+    if (len == 0){
+      len = deflog_record_len(rb, tail + whole);
+    }
+    if (whole + len > n){
+      break;
+    }
+    whole += len;
+    len = 0;
+  }
+
+  /* Not even one record fits before the end of the ring */
+  return whole != 0 ? whole : n;
+}
+
+/**
+ * @brief Releases bytes returned by the last deflog_peek().
+ *
+ * @param[in] n Number of bytes sent.
+ */
+void deflog_consume(uint32_t n){
+  ring_buffer_t *rb = deflog_source;
+
+  while (n != 0 && ring_count(rb) != 0){
+    if (deflog_left == 0){
+      deflog_left = deflog_record_len(rb, rb->tail);
+    }
+    uint32_t k = n < deflog_left ? n : deflog_left;
+    ring_consume(rb, k);
+    deflog_left -= k;
+    n -= k;
+  }
+}
+
+/**
+ * @brief Registers the ring user code logs into.
+ *
+ * @param[in] ring The user ring, NULL to stop draining it.
+ * @return 0 on success, -1 if the ring is not initialized.
+ */
+int sys_deflog_register(ring_buffer_t *ring){
+  if (ring != NULL && (ring->data == NULL || ring->mask == 0)){
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+  int err = 0;
+
+  /* Never drop the source of a record that is half on the wire */
+  if (deflog_left != 0 && deflog_source == user_ring){
+    err = -1;
+  }
+  else {
+    user_ring = ring;
+  }
+
+  restore_interrupt_state(state);
+  return err;
+}
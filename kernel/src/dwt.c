@@ -0,0 +1,52 @@
+/**
+ * @file dwt.c
+ *
+ * @brief Enables the DWT cycle counter used for kernel profiling.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <unistd.h>
+#include <dwt.h>
+
+/**
+ * @struct dwt_reg_map
+ * @brief Represents the memory-mapped DWT registers used here.
+ */
+struct dwt_reg_map {
+    volatile uint32_t CTRL;   /**< Control register. */
+    volatile uint32_t CYCCNT; /**< Cycle count register. */
+};
+
+/**
+ * @brief Base address of the DWT registers.
+ */
+#define DWT_BASE (struct dwt_reg_map *) 0xE0001000
+
+/**
+ * @brief Debug Exception and Monitor Control Register.
+ */
+#define DEMCR ((volatile uint32_t *) 0xE000EDFC)
+
+/**
+ * @brief Global enable for the DWT and ITM units.
+ */
+#define DEMCR_TRCENA (1 << 24)
+
+/**
+ * @brief Enables the cycle counter.
+ */
+#define DWT_CTRL_CYCCNTENA 1
+
+/**
+ * @brief Enables trace and starts the cycle counter from 0.
+ */
+void dwt_init() {
+    struct dwt_reg_map *dwt = DWT_BASE;
+
+    *DEMCR = *DEMCR | DEMCR_TRCENA;
+    dwt -> CYCCNT = 0;
+    dwt -> CTRL = dwt -> CTRL | DWT_CTRL_CYCCNTENA;
+}
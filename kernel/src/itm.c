@@ -0,0 +1,159 @@
+/**
+ * @file itm.c
+ *
+ * @brief Sets up the ITM, the TPIU and the SWO pin for kernel trace events.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <unistd.h>
+#include <itm.h>
+#include <gpio.h>
+#include <systick.h>
+
+/**
+ * @struct itm_reg_map
+ * @brief Represents the memory-mapped ITM control registers.
+ */
+struct itm_reg_map {
+    volatile uint32_t TER;          /**< Trace Enable Register, one bit per port. */
+    volatile uint32_t reserved0[15];
+    volatile uint32_t TPR;          /**< Trace Privilege Register, one bit per 8 ports. */
+    volatile uint32_t reserved1[15];
+    volatile uint32_t TCR;          /**< Trace Control Register. */
+    volatile uint32_t reserved2[75];
+    volatile uint32_t LAR;          /**< Lock Access Register. */
+};
+
+/**
+ * @brief Base address of the ITM control registers.
+ */
+#define ITM_BASE (struct itm_reg_map *) 0xE0000E00
+
+/**
+ * @brief Key that unlocks writes to the ITM registers.
+ */
+#define ITM_LAR_KEY 0xC5ACCE55
+
+/** @brief ITM Trace Control Register bits */
+//@{
+#define ITM_TCR_ITMENA (1 << 0)
+#define ITM_TCR_TRACEBUSID(id) ((id) << 16)
+//@}
+
+/** @brief TPIU registers */
+//@{
+#define TPIU_ACPR ((volatile uint32_t *) 0xE0040010)  /**< SWO clock prescaler. */
+#define TPIU_SPPR ((volatile uint32_t *) 0xE00400F0)  /**< Pin protocol. */
+#define TPIU_FFCR ((volatile uint32_t *) 0xE0040304)  /**< Formatter control. */
+//@}
+
+/** @brief SWO pin protocol: asynchronous NRZ, the UART encoding */
+#define TPIU_SPPR_NRZ 2
+
+/** @brief Formatter control: formatter off, only ITM goes out */
+#define TPIU_FFCR_TRIGIN (1 << 8)
+
+/**
+ * @brief STM32 DBGMCU control register.
+ */
+#define DBGMCU_CR ((volatile uint32_t *) 0xE0042004)
+
+/**
+ * @brief Enables the trace pins, TRACE_MODE 00 is asynchronous SWO.
+ */
+#define DBGMCU_CR_TRACE_IOEN (1 << 5)
+
+/**
+ * @brief Ports the kernel writes to.
+ */
+#define ITM_KERNEL_PORTS ((1 << ITM_PORT_TEXT) | (1 << ITM_PORT_SWITCH) | (1 << ITM_PORT_SVC_ENTER) \
+                          | (1 << ITM_PORT_SVC_EXIT) | (1 << ITM_PORT_ISR_ENTER) \
+                          | (1 << ITM_PORT_ISR_EXIT) | (1 << ITM_PORT_MARKER))
+
+/**
+ * @brief Events dropped because the ITM FIFO was full.
+ */
+volatile uint32_t itm_dropped;
+
+/**
+ * @brief Routes SWO to PB3 and enables the kernel stimulus ports.
+ *
+ * The debugger usually does the TPIU part as well, doing it here means
+ * any SWO viewer works once it listens at the right rate.
+ *
+ * @param[in] swo_baud SWO bit rate, 0 for ITM_SWO_BAUD.
+ */
+void itm_init(uint32_t swo_baud){
+#if ITM_TRACE
+  struct itm_reg_map *itm = ITM_BASE;
+
+  if (swo_baud == 0){
+    swo_baud = ITM_SWO_BAUD;
+  }
+
+  /* DEMCR.TRCENA powers the ITM, DWT and TPIU */
+  dwt_init();
+
+  *DBGMCU_CR = *DBGMCU_CR | DBGMCU_CR_TRACE_IOEN;
+  gpio_init(GPIO_B, 3, MODE_ALT, OUTPUT_PUSH_PULL, OUTPUT_SPEED_HIGH, PUPD_NONE, ALT0);
+
+  *TPIU_SPPR = TPIU_SPPR_NRZ;
+  *TPIU_ACPR = BASE_FREQ / swo_baud - 1;
+  *TPIU_FFCR = TPIU_FFCR_TRIGIN;
+
+  itm -> LAR = ITM_LAR_KEY;
+  itm -> TCR = ITM_TCR_ITMENA | ITM_TCR_TRACEBUSID(1);
+  /* Ports 0 to 7 privileged, so user code cannot fake kernel events */
+  itm -> TPR = 0x1;
+  itm -> TER = ITM_KERNEL_PORTS;
+  itm_dropped = 0;
+#else
+  (void)swo_baud;
+#endif
+}
+
+/**
+ * @brief Sends text on ITM_PORT_TEXT, waiting for room in the FIFO. At
+ *        2 Mbit/s a byte leaves in a few microseconds.
+ *
+ * @param[in] buf The bytes.
+ * @param[in] len Number of bytes.
+ * @return len, -1 if tracing is compiled out.
+ */
+int itm_write(const char *buf, int len){
+#if ITM_TRACE
+  volatile uint8_t *stim = (volatile uint8_t *)&ITM_STIM[ITM_PORT_TEXT];
+
+  for (int i = 0; i < len; i++){
+    while ((ITM_STIM[ITM_PORT_TEXT] & ITM_FIFOREADY) == 0){
+    }
+    *stim = buf[i];
+  }
+  return len;
+#else
+  (void)buf;
+  (void)len;
+  return -1;
+#endif
+}
+
+/**
+ * @brief Emits a user marker. Markers go through a syscall so that they get
+ *        the same cycle timestamp as the kernel events, which user code
+ *        cannot read.
+ *
+ * @param[in] id Marker ID, 8 bits.
+ * @return 0 on success, -1 if tracing is compiled out.
+ */
+int sys_trace_marker(uint32_t id){
+#if ITM_TRACE
+  itm_event(ITM_PORT_MARKER, id & 0xFF);
+  return 0;
+#else
+  (void)id;
+  return -1;
+#endif
+}
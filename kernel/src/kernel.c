@@ -19,6 +19,7 @@
 #include "printk.h"
 #include "uart_polling.h"
 #include "uart.h"
+#include "itm.h"
 #include "stdint.h"
 #include "syscall.h"
 #include "stdio.h"
@@ -33,7 +34,8 @@ int kernel_main() {
     init_349();  //Do not remove this function
     gpio_init(GPIO_A, 0, MODE_GP_OUTPUT, OUTPUT_PUSH_PULL, OUTPUT_SPEED_HIGH, PUPD_NONE, ALT0);
     gpio_init(GPIO_B, 10, MODE_GP_OUTPUT, OUTPUT_PUSH_PULL, OUTPUT_SPEED_HIGH, PUPD_NONE, ALT0);
-    uart_init(0);
+    uart_init(UART_DEFAULT_BAUD);
+    itm_init(ITM_SWO_BAUD);
     //timer_init(2, 160, 1);
     
     
@@ -13,30 +13,72 @@
 #include <uart_polling.h>
 
 /**
- * allows for numbers with 64 digits/letters
+ * allows for 32-bit numbers in octal, the longest base
  */
-#define MAXBUF (sizeof(uint32_t))
+#define MAXBUF 11
+
+/**
+ * line buffer size, longer lines go out in several records
+ */
+#define PRINTK_LINE 128
 
 /**
  * static array of digits for use in printnum(s)
  */
 static char digits[] = "0123456789abcdef";
 
-void uart_wrapper(char c)
+/**
+ * @brief      Output of one printk() call. It lives on the caller's stack,
+ *             so every thread and interrupt formats into its own.
+ */
+typedef struct
+{
+  char buf[PRINTK_LINE]; /**< Characters not queued yet. */
+  uint32_t len;          /**< Number of characters in buf. */
+} printk_line_t;
+
+/**
+ * @brief      Queues the buffered characters as one record, so they reach
+ *             the UART together whatever else is printing.
+ *
+ * @param      line  the line buffer
+ */
+static void printk_flush(printk_line_t *line)
 {
-  // @TODO change to interrupt based put byte
-  //   uart_polling_put_byte( c );
-  while (uart_put_byte(c))
-    ;
+  uint32_t sent = 0;
+
+  // printk may run in an interrupt, so it cannot sleep for room
+  while (sent < line->len)
+  {
+    sent += uart_write_record(&line->buf[sent], line->len - sent);
+  }
+  line->len = 0;
+}
+
+/**
+ * @brief      Adds a character, queueing the line at a newline or when
+ *             the buffer is full.
+ *
+ * @param      line  the line buffer
+ * @param[in]  c     the character
+ */
+static void uart_wrapper(printk_line_t *line, char c)
+{
+  line->buf[line->len++] = c;
+  if (c == '\n' || line->len == PRINTK_LINE)
+  {
+    printk_flush(line);
+  }
 }
 
 /**
  * @brief      prints a number
  *
+ * @param      line  the line buffer
  * @param      base  8, 10, 16
  * @param      num   the number to print
  */
-static void printnumk(uint8_t base, uint32_t num)
+static void printnumk(printk_line_t *line, uint8_t base, uint32_t num)
 {
   int8_t *prefix = 0;
   int8_t buf[MAXBUF];
@@ -64,19 +106,23 @@ static void printnumk(uint8_t base, uint32_t num)
   {
     while (*prefix)
     {
-      uart_wrapper(*prefix++);
+      uart_wrapper(line, *prefix++);
     }
   }
 
   while (++ptr != &buf[MAXBUF])
   {
-    uart_wrapper(*ptr);
+    uart_wrapper(line, *ptr);
   }
 }
 
 /**
  * @brief      A kernel printf() function for debugging the kernel
  *
+ *             Output is collected into lines and every line is queued in
+ *             one piece, so lines from different threads and interrupts
+ *             do not interleave.
+ *
  * @param      fmt        the format string
  * @param[in]  <unnamed>  variadic input
  *
@@ -85,6 +131,9 @@ static void printnumk(uint8_t base, uint32_t num)
 int printk(const char *fmt, ...)
 {
   va_list args;
+  printk_line_t line;
+  line.len = 0;
+
   // set up va_list and print it
   va_start(args, fmt);
 
@@ -94,7 +143,7 @@ int printk(const char *fmt, ...)
     // handle normal characters
     if (*fmt != '%')
     {
-      uart_wrapper(*fmt++);
+      uart_wrapper(&line, *fmt++);
       continue;
     }
 
@@ -110,12 +159,12 @@ int printk(const char *fmt, ...)
 
       if (num < 0)
       {
-        uart_wrapper('-');
-        printnumk(10, -num);
+        uart_wrapper(&line, '-');
+        printnumk(&line, 10, -num);
       }
       else
       {
-        printnumk(10, num);
+        printnumk(&line, 10, num);
       }
 
       break;
@@ -124,14 +173,14 @@ int printk(const char *fmt, ...)
     case 'u':
     { // unsigned decimal
       uint32_t num = va_arg(args, uint32_t);
-      printnumk(10, num);
+      printnumk(&line, 10, num);
       break;
     }
 
     case 'o':
     { // octal
       uint32_t num = va_arg(args, uint32_t);
-      printnumk(8, num);
+      printnumk(&line, 8, num);
       break;
     }
 
@@ -139,7 +188,7 @@ int printk(const char *fmt, ...)
     case 'p':
     { // pointer
       uint32_t num = va_arg(args, uint32_t);
-      printnumk(16, num);
+      printnumk(&line, 16, num);
       break;
     }
 
@@ -149,7 +198,7 @@ int printk(const char *fmt, ...)
 
       while (*byte_ptr)
       {
-        uart_wrapper(*byte_ptr);
+        uart_wrapper(&line, *byte_ptr);
         byte_ptr++;
       }
 
@@ -159,18 +208,19 @@ int printk(const char *fmt, ...)
     case 'c':
     { // character
       int32_t byte = va_arg(args, int32_t);
-      uart_wrapper(byte);
+      uart_wrapper(&line, byte);
       break;
     }
 
     case '%':
     { // escaped percent symbol
-      uart_wrapper('%');
+      uart_wrapper(&line, '%');
       break;
     }
 
     default:
     { // error
+      printk_flush(&line);
       va_end(args);
       return -1;
     }
@@ -179,6 +229,7 @@ int printk(const char *fmt, ...)
     fmt++;
   }
 
+  printk_flush(&line);
   va_end(args);
   return 0;
 }
@@ -0,0 +1,82 @@
+/**
+ * @file   sched_trace.c
+ *
+ * @brief  Storage of the scheduler trace and the dump that sends it over
+ *         the UART.
+ *
+ *         The dump goes through the kernel log ring, so the records reach
+ *         the wire whole and in between text, never inside it, and the
+ *         console stays readable with deflog_decode.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <sched_trace.h>
+#include <syscall_thread.h>
+#include <klog.h>
+#include <uart.h>
+
+#if SCHED_TRACE
+
+_Static_assert((SCHED_TRACE_RECORDS & (SCHED_TRACE_RECORDS - 1)) == 0,
+               "SCHED_TRACE_RECORDS must be a power of two");
+
+/** @brief The ring, indexed by the free running sched_trace_head. */
+sched_trace_record_t sched_trace_buf[SCHED_TRACE_RECORDS];
+
+/** @brief Number of records written since the last dump. */
+uint32_t sched_trace_head;
+
+/** @brief Set while a dump is sending the ring. */
+volatile uint32_t sched_trace_paused;
+
+/**
+ * @brief Queues one record in the kernel log ring, waiting for the UART to
+ *        make room. Threads sleep a tick at a time, the default thread,
+ *        which may not sleep, polls.
+ *
+ * @param[in] cycles First argument of the record.
+ * @param[in] info Second argument of the record.
+ */
+static void sched_trace_send(uint32_t cycles, uint32_t info){
+  const uint32_t args[2] = { cycles, info };
+
+  while (deflog_write(&klog_ring, DEFLOG_ID_SCHED_TRACE, args, 2) < 0){
+    uart_tx_poll();
+    sys_sleep_for(1);
+  }
+}
+
+#endif /* SCHED_TRACE */
+
+/**
+ * @brief Sends the recorded events, oldest first, and starts over with an
+ *        empty ring. Recording stops while the records go out, the dump
+ *        itself would fill the ring with its own sleeps otherwise.
+ *
+ * @return Number of records sent, -1 if tracing is compiled out.
+ */
+int sys_sched_trace_dump(){
+#if SCHED_TRACE
+  sched_trace_paused = 1;
+
+  uint32_t head = sched_trace_head;
+  uint32_t count = head < SCHED_TRACE_RECORDS ? head : SCHED_TRACE_RECORDS;
+
+  sched_trace_send(head - count,
+                   SCHED_TRACE_INFO(SCHED_TRACE_START, global_threads_info.max_threads,
+                                    0, SCHED_TRACE_NO_MUTEX));
+  for (uint32_t i = head - count; i != head; i++){
+    sched_trace_record_t *r = &sched_trace_buf[i & (SCHED_TRACE_RECORDS - 1)];
+    sched_trace_send(r->cycles, r->info);
+  }
+
+  sched_trace_head = 0;
+  sched_trace_paused = 0;
+  return count;
+#else
+  return -1;
+#endif
+}
@@ -11,9 +11,20 @@
 #include <stdint.h>
 #include <debug.h>
 #include <syscall.h>
+#include <syscall_fd.h>
 #include <syscall_thread.h>
 #include <syscall_mutex.h>
 #include <servok.h>
+#include <syscall_sem.h>
+#include <syscall_event.h>
+#include <syscall_msgq.h>
+#include <syscall_rwlock.h>
+#include <syscall_barrier.h>
+#include <syscall_cond.h>
+#include <syscall_swtimer.h>
+#include <klog.h>
+#include <itm.h>
+#include <sched_trace.h>
 
 /**
  * @brief Attribute to mark unused function parameters.
@@ -56,6 +67,7 @@ void svc_c_handler( uint32_t * stack_p ) {
   uint32_t svc_instruction = *(((uint16_t*)pc_pointer) - 1);
   /* Extracting Lower 8 Bits Which Are SVC Number*/
   uint32_t svc_number = (svc_instruction & 0xFF);
+  itm_svc_enter(svc_number);
   uint32_t first_arg = (stack -> R0);
   uint32_t second_arg = (stack -> R1);
   uint32_t third_arg = (stack -> R2);
@@ -69,6 +81,7 @@ void svc_c_handler( uint32_t * stack_p ) {
   int res_read;
   int servo_enable;
   int servo_set;
+  uint64_t time_us; // also holds the 64-bit cycle counts
 
   kmutex_t * mutex;
   switch ( svc_number ) {
@@ -81,17 +94,16 @@ void svc_c_handler( uint32_t * stack_p ) {
       stack -> R0 = res_write;
     break;
     case 2:
-      stack -> R0 = 1;
-
+      stack -> R0 = sys_close(first_arg);
     break;
     case 3:
-      stack -> R0 = 1;
+      stack -> R0 = sys_fstat(first_arg, (void*)second_arg);
     break;
     case 4:
-      stack -> R0 = 1;
+      stack -> R0 = sys_isatty(first_arg);
     break;
     case 5:
-      stack -> R0 = 1;
+      stack -> R0 = sys_lseek(first_arg, second_arg, third_arg);
     break;
     case 6:
       res_read = sys_read(first_arg, (char*)second_arg, third_arg);
@@ -142,9 +154,155 @@ void svc_c_handler( uint32_t * stack_p ) {
       servo_set = sys_servo_set((uint8_t)first_arg,(int)second_arg);
       stack -> R0 = servo_set;
     break;
+    case 24:
+      stack -> R0 = (uint32_t)sys_sem_init(first_arg, second_arg);
+    break;
+    case 25:
+      stack -> R0 = sys_sem_wait((ksem_t*)first_arg);
+    break;
+    case 26:
+      stack -> R0 = sys_sem_try_wait((ksem_t*)first_arg);
+    break;
+    case 27:
+      stack -> R0 = sys_sem_post((ksem_t*)first_arg);
+    break;
+    case 28:
+      stack -> R0 = (uint32_t)sys_event_init();
+    break;
+    case 29:
+      stack -> R0 = sys_event_wait((kevent_t*)first_arg, second_arg, third_arg, (uint32_t*)fourth_arg);
+    break;
+    case 30:
+      stack -> R0 = sys_event_set((kevent_t*)first_arg, second_arg);
+    break;
+    case 31:
+      stack -> R0 = sys_event_clear((kevent_t*)first_arg, second_arg);
+    break;
+    case 32:
+      stack -> R0 = (uint32_t)sys_msgq_init((void*)first_arg, second_arg, third_arg);
+    break;
+    case 33:
+      stack -> R0 = sys_msgq_reserve((kmsgq_t*)first_arg, (void**)second_arg, third_arg);
+    break;
+    case 34:
+      stack -> R0 = sys_msgq_commit((kmsgq_t*)first_arg, (void*)second_arg);
+    break;
+    case 35:
+      stack -> R0 = sys_msgq_receive((kmsgq_t*)first_arg, (void**)second_arg, third_arg);
+    break;
+    case 36:
+      stack -> R0 = sys_msgq_release((kmsgq_t*)first_arg, (void*)second_arg);
+    break;
+    case 37:
+      stack -> R0 = sys_msgq_high_water((kmsgq_t*)first_arg);
+    break;
+    case 38:
+      stack -> R0 = sys_mutex_lock_timed((kmutex_t*)first_arg, second_arg);
+    break;
+    case 39:
+      stack -> R0 = sys_sem_wait_timed((ksem_t*)first_arg, second_arg);
+    break;
+    case 40:
+      stack -> R0 = sys_event_wait_timed((kevent_t*)first_arg, second_arg, third_arg, (uint32_t*)fourth_arg, fifth_arg);
+    break;
+    case 41:
+      stack -> R0 = sys_mutex_declare((kmutex_t*)first_arg, second_arg, third_arg);
+    break;
+    case 42:
+      stack -> R0 = sys_mutex_profile_dump();
+    break;
+    case 43:
+      stack -> R0 = (uint32_t)sys_rwlock_init(first_arg, second_arg);
+    break;
+    case 44:
+      stack -> R0 = sys_rwlock_read_lock((krwlock_t*)first_arg, second_arg);
+    break;
+    case 45:
+      stack -> R0 = sys_rwlock_write_lock((krwlock_t*)first_arg, second_arg);
+    break;
+    case 46:
+      stack -> R0 = sys_rwlock_unlock((krwlock_t*)first_arg);
+    break;
+    case 47:
+      stack -> R0 = sys_rwlock_declare((krwlock_t*)first_arg, second_arg, third_arg, fourth_arg);
+    break;
+    case 48:
+      stack -> R0 = (uint32_t)sys_barrier_init(first_arg);
+    break;
+    case 49:
+      stack -> R0 = sys_barrier_wait((kbarrier_t*)first_arg, second_arg);
+    break;
+    case 50:
+      stack -> R0 = (uint32_t)sys_phase_init();
+    break;
+    case 51:
+      stack -> R0 = sys_phase_signal((kphase_t*)first_arg);
+    break;
+    case 52:
+      stack -> R0 = sys_phase_wait((kphase_t*)first_arg, second_arg, third_arg);
+    break;
+    case 53:
+      stack -> R0 = (uint32_t)sys_cond_init((kmutex_t*)first_arg);
+    break;
+    case 54:
+      stack -> R0 = sys_cond_wait((kcond_t*)first_arg, second_arg);
+    break;
+    case 55:
+      stack -> R0 = sys_cond_signal((kcond_t*)first_arg);
+    break;
+    case 56:
+      stack -> R0 = sys_cond_broadcast((kcond_t*)first_arg);
+    break;
+    case 57:
+      stack -> R0 = (uint32_t)sys_swtimer_create((kevent_t*)first_arg, second_arg);
+    break;
+    case 58:
+      stack -> R0 = sys_swtimer_start((kswtimer_t*)first_arg, second_arg, third_arg);
+    break;
+    case 59:
+      stack -> R0 = sys_swtimer_cancel((kswtimer_t*)first_arg);
+    break;
+    case 60:
+      stack -> R0 = sys_swtimer_wait((kswtimer_t*)first_arg, second_arg);
+    break;
+    case 61:
+      stack -> R0 = sys_sleep_until(first_arg);
+    break;
+    case 62:
+      stack -> R0 = sys_sleep_for(first_arg);
+    break;
+    case 63:
+      // 64-bit results come back in R0:R1
+      time_us = sys_get_time_us();
+      stack -> R0 = (uint32_t)time_us;
+      stack -> R1 = (uint32_t)(time_us >> 32);
+    break;
+    case 64:
+      time_us = sys_thread_time_cycles();
+      stack -> R0 = (uint32_t)time_us;
+      stack -> R1 = (uint32_t)(time_us >> 32);
+    break;
+    case 65:
+      time_us = sys_thread_time_us();
+      stack -> R0 = (uint32_t)time_us;
+      stack -> R1 = (uint32_t)(time_us >> 32);
+    break;
+    case 66:
+      stack -> R0 = sys_uart_set_baud(first_arg);
+    break;
+    case 67:
+      stack -> R0 = sys_deflog_register((ring_buffer_t *)first_arg);
+    break;
+    case 68:
+      stack -> R0 = sys_trace_marker(first_arg);
+    break;
+    case 69:
+      stack -> R0 = sys_sched_trace_dump();
+    break;
 
   default:
     DEBUG_PRINT( "Not implemented, svc num %d\n", svc_number );
     ASSERT( 0 );
   }
+  itm_svc_exit(svc_number);
 }
\ No newline at end of file
@@ -57,77 +57,6 @@ void *sys_sbrk(int incr){
   return (void*)previous_heap_end;
 }
 
-/**
- * @brief Writes data to STDOUT.
- *
- * This function writes the specified number of bytes from the buffer to
- * the standard output (UART). It blocks until all bytes are written.
- *
- * @param[in] file The file descriptor (must be 1 for STDOUT).
- * @param[in] ptr Pointer to the buffer containing the data to write.
- * @param[in] len The number of bytes to write.
- * @return The number of bytes written on success, or -1 if the file descriptor is invalid.
- */
-int sys_write(int file, char *ptr, int len){
-  if (file != 1) {return -1;}
-  
- for(int i = 0; i < len; i++){
-   while(uart_put_byte(ptr[i]) );
- }
-  return len;
-}
-
-/**
- * @brief Reads data from STDIN and echoes it back.
- *
- * This function reads up to the specified number of bytes from the standard
- * input (UART) into the buffer. It echoes the input back to the standard output.
- *
- * @param[in] file The file descriptor (must be 0 for STDIN).
- * @param[out] ptr Pointer to the buffer where the input data will be stored.
- * @param[in] len The maximum number of bytes to read.
- * @return The number of bytes read on success, or -1 if the file descriptor is invalid.
- */
-int sys_read(int file, char *ptr, int len){
-  if (file != 0) {return -1;} /* Case For Not Reading From STDIN*/
-  char c[2];
-  c[0] = 'M';
-  c[1] = '\0';
-  int curr_ind = 0;
-  while (curr_ind < len){
-    if (uart_get_byte(c) < 0){
-      continue;
-    };
-
-    /* End Of Trans Character */
-    if (c[0] == 4){ return curr_ind;} 
-
-    /* Backspace Character */
-    else if (c[0] == '\b'){
-      if (curr_ind > 0){
-        curr_ind -= 1;}
-        printk("\b \b");
-        continue;
-      }
-
-
-    /* New Line */
-    else if (c[0] == '\n'){
-      ptr[curr_ind] = '\n';
-      printk(c);
-      curr_ind ++;
-      return curr_ind;}
-    
-    /* Regular Character */
-    else {
-      ptr[curr_ind] = c[0];
-      printk(c);}
-
-    curr_ind ++;
-  }
-  return len;
-}
-
 /**
  * @brief Terminates the program.
  *
@@ -143,4 +72,20 @@ void sys_exit(int status){
   disable_interrupts();
   while (1) {
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Changes the baud rate of STDIN/STDOUT.
+ *
+ * Output queued before the call is sent at the old rate.
+ *
+ * @param[in] baud The baud rate.
+ * @return 0 on success, -1 if the rate cannot be reached.
+ */
+int sys_uart_set_baud(uint32_t baud){
+  if (uart_set_baud_rate(baud) < 0){
+    printk("Warning: baud rate %d cannot be generated from the UART clock\n", baud);
+    return -1;
+  }
+  return 0;
+}
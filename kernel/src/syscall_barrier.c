@@ -0,0 +1,219 @@
+/**
+ * @file syscall_barrier.c
+ *
+ * @brief Barriers and phase rendezvous. A waiter that also asked for its
+ *        next period keeps TCB->wait_period set until SysTick sees its
+ *        period start. When the rendezvous completes, such a waiter goes to
+ *        WAITING (released by SysTick at its period) instead of READY.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_barrier.h>
+#include <syscall_thread.h>
+#include <wait_queue.h>
+#include <arm.h>
+
+/**
+ * @brief global array for storing barrier information
+ */
+kbarrier_t barrier_array[MAX_BARRIERS];
+
+/**
+ * @brief global array for storing phase information
+ */
+kphase_t phase_array[MAX_PHASES];
+
+/**
+ * @brief index of the next free barrier in barrier_array
+ */
+static uint32_t barrier_index;
+
+/**
+ * @brief index of the next free phase in phase_array
+ */
+static uint32_t phase_index;
+
+/**
+ * @brief Resets every barrier and phase.
+ */
+void initialize_barrier_array(){
+  for (uint32_t i = 0; i < MAX_BARRIERS; i++){
+    barrier_array[i].parties = 0;
+    barrier_array[i].arrived = 0;
+    barrier_array[i].index = i;
+    wait_queue_init(&barrier_array[i].waiters);
+  }
+  for (uint32_t i = 0; i < MAX_PHASES; i++){
+    phase_array[i].phase = 0;
+    phase_array[i].index = i;
+    wait_queue_init(&phase_array[i].waiters);
+  }
+  barrier_index = 0;
+  phase_index = 0;
+}
+
+/**
+ * @brief Puts the current thread to sleep on a rendezvous. Must be called
+ *        with interrupts disabled, which it restores.
+ *
+ * @param[in] wq The wait queue of the rendezvous.
+ * @param[in] flags Rendezvous flags.
+ * @param[in] state Interrupt state to restore.
+ * @return The wait status, -1 if the caller may not block.
+ */
+static int32_t rendezvous_sleep(wait_queue_t *wq, uint32_t flags, int state){
+  int err = wait_queue_enqueue(wq, WAIT_FOREVER);
+  if (err < 0){
+    restore_interrupt_state(state);
+    return err;
+  }
+  TCB_ARRAY[global_threads_info.current_thread].wait_period = (flags & RENDEZVOUS_NEXT_PERIOD) ? 1 : 0;
+  restore_interrupt_state(state);
+  return wait_queue_sleep();
+}
+
+/**
+ * @brief Releases a rendezvous waiter. A waiter whose period has not started
+ *        yet is left WAITING for SysTick to release it. Must be called with
+ *        interrupts disabled.
+ *
+ * @param[in] wq The wait queue of the rendezvous.
+ * @param[in] thread The waiter.
+ * @param[in] status Status handed to the waiter.
+ */
+static void rendezvous_release(wait_queue_t *wq, uint32_t thread, int32_t status){
+  wait_queue_wake_thread(wq, thread, status);
+  if (TCB_ARRAY[thread].wait_period){
+    TCB_ARRAY[thread].wait_period = 0;
+    TCB_ARRAY[thread].state = WAITING;
+  }
+}
+
+/**
+ * @brief Hands out the next free barrier.
+ *
+ * @param[in] parties Number of threads per round.
+ * @return Pointer to the barrier, NULL on failure.
+ */
+kbarrier_t *sys_barrier_init(uint32_t parties){
+  if (barrier_index >= MAX_BARRIERS || parties == 0){
+    return NULL;
+  }
+
+  kbarrier_t *barrier = &barrier_array[barrier_index];
+  barrier->parties = parties;
+  barrier->arrived = 0;
+  barrier_index++;
+
+  return barrier;
+}
+
+/**
+ * @brief Arrives at a barrier.
+ *
+ * The last thread to arrive releases the whole round at once; every
+ * released thread becomes runnable in the same scheduling pass, so they
+ * start in priority order.
+ *
+ * @param[in] barrier The barrier.
+ * @param[in] flags Rendezvous flags.
+ * @return BARRIER_LAST for the completing thread, 0 for the others, -1 on
+ *         failure.
+ */
+int sys_barrier_wait(kbarrier_t *barrier, uint32_t flags){
+  int state = save_interrupt_state_and_disable();
+
+  if (barrier->arrived + 1 < barrier->parties){
+    barrier->arrived++;
+    int32_t status = rendezvous_sleep(&barrier->waiters, flags, state);
+    if (status < 0){
+      // Could not block, so it never arrived
+      state = save_interrupt_state_and_disable();
+      barrier->arrived--;
+      restore_interrupt_state(state);
+    }
+    return status;
+  }
+
+  barrier->arrived = 0;
+  uint32_t waiters = barrier->waiters.waiters;
+  while (waiters != 0){
+    uint32_t thread = __builtin_ctz(waiters);
+    waiters &= ~(1U << thread);
+    rendezvous_release(&barrier->waiters, thread, WAIT_OK);
+  }
+  restore_interrupt_state(state);
+
+  if (flags & RENDEZVOUS_NEXT_PERIOD){
+    sys_wait_until_next_period();
+  }
+  return BARRIER_LAST;
+}
+
+/**
+ * @brief Hands out the next free phase counter.
+ *
+ * @return Pointer to the phase, NULL if none are left.
+ */
+kphase_t *sys_phase_init(){
+  if (phase_index >= MAX_PHASES){
+    return NULL;
+  }
+
+  kphase_t *phase = &phase_array[phase_index];
+  phase->phase = 0;
+  phase_index++;
+
+  return phase;
+}
+
+/**
+ * @brief Completes a phase and releases the waiters whose target it reached.
+ *
+ * @param[in] phase The phase counter.
+ * @return The new phase count.
+ */
+uint32_t sys_phase_signal(kphase_t *phase){
+  int state = save_interrupt_state_and_disable();
+
+  uint32_t now = ++phase->phase;
+  uint32_t waiters = phase->waiters.waiters;
+  while (waiters != 0){
+    uint32_t thread = __builtin_ctz(waiters);
+    waiters &= ~(1U << thread);
+    // Wrap safe check of the waiter's target phase
+    if ((int32_t)(now - TCB_ARRAY[thread].wait_mask) >= 0){
+      rendezvous_release(&phase->waiters, thread, WAIT_OK);
+    }
+  }
+
+  restore_interrupt_state(state);
+  return now;
+}
+
+/**
+ * @brief Waits for a phase counter to reach a target.
+ *
+ * @param[in] phase The phase counter.
+ * @param[in] target Phase count to wait for.
+ * @param[in] flags Rendezvous flags.
+ * @return 0 on success, -1 on failure.
+ */
+int sys_phase_wait(kphase_t *phase, uint32_t target, uint32_t flags){
+  int state = save_interrupt_state_and_disable();
+
+  if ((int32_t)(phase->phase - target) >= 0){
+    restore_interrupt_state(state);
+    if (flags & RENDEZVOUS_NEXT_PERIOD){
+      sys_wait_until_next_period();
+    }
+    return 0;
+  }
+
+  TCB_ARRAY[global_threads_info.current_thread].wait_mask = target;
+  return rendezvous_sleep(&phase->waiters, flags, state);
+}
@@ -0,0 +1,176 @@
+/**
+ * @file syscall_cond.c
+ *
+ * @brief Condition variables. A signalled waiter is not woken to fight for
+ *        the mutex: it is moved straight from the condition's wait queue to
+ *        the mutex's, or given the mutex if it is free. Either way it only
+ *        runs again once it owns the mutex, and each waiter costs a constant
+ *        amount of work.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_cond.h>
+#include <syscall_thread.h>
+#include <wait_queue.h>
+#include <printk.h>
+#include <arm.h>
+
+/**
+ * @brief global array for storing condition variable information
+ */
+kcond_t cond_array[MAX_CONDS];
+
+/**
+ * @brief index of the next free condition variable in cond_array
+ */
+static uint32_t cond_index;
+
+/**
+ * @brief Resets every condition variable.
+ */
+void initialize_cond_array(){
+  for (uint32_t i = 0; i < MAX_CONDS; i++){
+    cond_array[i].mutex = NULL;
+    cond_array[i].index = i;
+    wait_queue_init(&cond_array[i].waiters);
+  }
+  cond_index = 0;
+}
+
+/**
+ * @brief Hands out the next free condition variable.
+ *
+ * @param[in] mutex The mutex protecting the predicate.
+ * @return Pointer to the condition variable, NULL on failure.
+ */
+kcond_t *sys_cond_init(kmutex_t *mutex){
+  if (cond_index >= MAX_CONDS || mutex == NULL){
+    return NULL;
+  }
+
+  kcond_t *cond = &cond_array[cond_index];
+  cond->mutex = mutex;
+  cond_index++;
+
+  return cond;
+}
+
+/**
+ * @brief Waits on a condition variable.
+ *
+ * The enqueue and the release of the mutex happen with interrupts disabled,
+ * so a signal sent right after the release cannot be lost. The waiter must
+ * hold no other mutex: under IPCP it would keep running at that ceiling
+ * while asleep and nobody could safely wake it.
+ *
+ * @param[in] cond The condition variable.
+ * @param[in] timeout Ticks to wait for a signal.
+ * @return 0 when signalled, WAIT_TIMEOUT on timeout, -1 on misuse.
+ */
+int sys_cond_wait(kcond_t *cond, uint32_t timeout){
+  uint32_t current_thread = global_threads_info.current_thread;
+  kmutex_t *mutex = cond->mutex;
+
+  if (mutex->locked_by != current_thread){
+    printk("Warning: Thread %d waits on condition %d without holding mutex %d\n",
+           current_thread, cond->index, mutex->index);
+    return -1;
+  }
+  if (TCB_ARRAY[current_thread].held_mutex_bitmap != (1U << mutex->index)){
+    printk("Warning: Thread %d waits on condition %d while holding other mutexes\n",
+           current_thread, cond->index);
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+
+  int err = wait_queue_enqueue(&cond->waiters, timeout);
+  if (err < 0){
+    restore_interrupt_state(state);
+    return err;
+  }
+
+  //release the mutex and fall back to the static priority
+  mutex_give(mutex);
+  TCB_ARRAY[current_thread].held_mutex_bitmap &= ~(1U << mutex->index);
+  thread_update_priority(current_thread);
+  restore_interrupt_state(state);
+
+  int32_t status = wait_queue_sleep();
+  if (status == WAIT_OK){
+    //the mutex was handed over on the way out of the wait
+    return 0;
+  }
+
+  //timed out still on the condition, so take the mutex back the normal way
+  int lock_status = sys_mutex_lock_timed(mutex, WAIT_FOREVER);
+  return lock_status < 0 ? lock_status : status;
+}
+
+/**
+ * @brief Passes a waiter from the condition on to the mutex. Must be called
+ *        with interrupts disabled.
+ *
+ * @param[in] cond The condition variable.
+ * @param[in] thread The waiter.
+ */
+static void cond_requeue(kcond_t *cond, uint32_t thread){
+  kmutex_t *mutex = cond->mutex;
+
+  if (mutex->locked_by == NOT_LOCKED){
+    mutex_take(mutex, thread);
+    wait_queue_wake_thread(&cond->waiters, thread, WAIT_OK);
+    return;
+  }
+
+  //keep sleeping until the owner hands the mutex over at unlock
+  wait_queue_move(&cond->waiters, &mutex->waiters, thread);
+  TCB_ARRAY[thread].waiting_mutex_bitmap |= (1U << mutex->index);
+}
+
+/**
+ * @brief Wakes the highest priority waiter of a condition variable.
+ *
+ * @param[in] cond The condition variable.
+ * @return Number of threads woken.
+ */
+uint32_t sys_cond_signal(kcond_t *cond){
+  int state = save_interrupt_state_and_disable();
+
+  uint32_t woken = 0;
+  uint32_t waiters = cond->waiters.waiters;
+  if (waiters != 0){
+    cond_requeue(cond, __builtin_ctz(waiters));
+    woken = 1;
+  }
+
+  restore_interrupt_state(state);
+  return woken;
+}
+
+/**
+ * @brief Wakes every waiter of a condition variable, highest priority
+ *        first.
+ *
+ * @param[in] cond The condition variable.
+ * @return Number of threads woken.
+ */
+uint32_t sys_cond_broadcast(kcond_t *cond){
+  int state = save_interrupt_state_and_disable();
+
+  uint32_t woken = 0;
+  uint32_t waiters = cond->waiters.waiters;
+  while (waiters != 0){
+    uint32_t thread = __builtin_ctz(waiters);
+    waiters &= ~(1U << thread);
+    cond_requeue(cond, thread);
+    woken++;
+  }
+
+  restore_interrupt_state(state);
+  return woken;
+}
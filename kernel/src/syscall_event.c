@@ -0,0 +1,184 @@
+/**
+ * @file syscall_event.c
+ *
+ * @brief Event flag groups. Each waiter stores its mask and options in its
+ *        TCB so sys_event_set() can decide who to wake without any extra
+ *        per-waiter storage.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_event.h>
+#include <syscall_thread.h>
+#include <wait_queue.h>
+#include <arm.h>
+
+/**
+ * @brief global array for storing event group information
+ */
+kevent_t event_array[MAX_EVENTS];
+
+/**
+ * @brief index of the next free event group in event_array
+ */
+static uint32_t event_index;
+
+/**
+ * @brief Checks whether a set of flags satisfies a wait.
+ *
+ * @param[in] flags Current flags.
+ * @param[in] mask Flags waited for.
+ * @param[in] options Wait options.
+ * @return 1 if satisfied, 0 otherwise.
+ */
+static int event_satisfied(uint32_t flags, uint32_t mask, uint32_t options){
+  if (options & EVENT_WAIT_ALL){
+    return (flags & mask) == mask;
+  }
+  return (flags & mask) != 0;
+}
+
+/**
+ * @brief Resets every group in the global event array.
+ */
+void initialize_event_array(){
+  for (uint32_t i = 0; i < MAX_EVENTS; i++){
+    event_array[i].flags = 0;
+    event_array[i].index = i;
+    wait_queue_init(&event_array[i].waiters);
+  }
+  event_index = 0;
+}
+
+/**
+ * @brief Hands out the next free event group.
+ *
+ * @return Pointer to the group, NULL if none are left.
+ */
+kevent_t *sys_event_init(){
+  if (event_index >= MAX_EVENTS){
+    return NULL;
+  }
+
+  kevent_t *event = &event_array[event_index];
+  event->flags = 0;
+  wait_queue_init(&event->waiters);
+  event_index++;
+
+  return event;
+}
+
+/**
+ * @brief Waits for flags, sleeping if they are not already set.
+ *
+ * @param[in] event The group.
+ * @param[in] mask Flags waited for.
+ * @param[in] options Wait options.
+ * @param[out] flags_out Flags that satisfied the wait, may be NULL.
+ * @return 0 on success, -1 on failure.
+ */
+int sys_event_wait(kevent_t *event, uint32_t mask, uint32_t options, uint32_t *flags_out){
+  return sys_event_wait_timed(event, mask, options, flags_out, WAIT_FOREVER);
+}
+
+/**
+ * @brief Waits at most timeout ticks for flags, sleeping if they are not
+ *        already set.
+ *
+ * @param[in] event The group.
+ * @param[in] mask Flags waited for.
+ * @param[in] options Wait options.
+ * @param[out] flags_out Flags that satisfied the wait, may be NULL.
+ * @param[in] timeout Ticks to wait at most, WAIT_FOREVER for no limit.
+ * @return 0 on success, WAIT_TIMEOUT if the timeout expired, -1 on failure.
+ */
+int sys_event_wait_timed(kevent_t *event, uint32_t mask, uint32_t options, uint32_t *flags_out, uint32_t timeout){
+  if (mask == 0){
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+
+  if (event_satisfied(event->flags, mask, options)){
+    if (flags_out != NULL){
+      *flags_out = event->flags;
+    }
+    if (options & EVENT_CLEAR){
+      event->flags &= ~mask;
+    }
+    restore_interrupt_state(state);
+    return 0;
+  }
+
+  int err = wait_queue_enqueue(&event->waiters, timeout);
+  if (err < 0){
+    restore_interrupt_state(state);
+    return err;
+  }
+  TCB_t *TCB = &TCB_ARRAY[global_threads_info.current_thread];
+  TCB->wait_mask = mask;
+  TCB->wait_options = options;
+
+  restore_interrupt_state(state);
+  int32_t status = wait_queue_sleep();
+
+  /* sys_event_set() stores the satisfying flags in wait_mask */
+  if (status == WAIT_OK && flags_out != NULL){
+    *flags_out = TCB->wait_mask;
+  }
+  return status;
+}
+
+/**
+ * @brief Sets flags and wakes satisfied waiters in priority order.
+ *
+ * Waiters are visited lowest bit first, so when several threads consume the
+ * same flag with EVENT_CLEAR the highest priority one gets it.
+ *
+ * @param[in] event The group.
+ * @param[in] mask Flags to set.
+ * @return The flags left set.
+ */
+uint32_t sys_event_set(kevent_t *event, uint32_t mask){
+  int state = save_interrupt_state_and_disable();
+
+  event->flags |= mask;
+
+  uint32_t pending = event->waiters.waiters;
+  while (pending != 0){
+    uint32_t thread = __builtin_ctz(pending);
+    pending &= ~(1 << thread);
+
+    TCB_t *TCB = &TCB_ARRAY[thread];
+    uint32_t wait_mask = TCB->wait_mask;
+    if (event_satisfied(event->flags, wait_mask, TCB->wait_options)){
+      TCB->wait_mask = event->flags;
+      if (TCB->wait_options & EVENT_CLEAR){
+        event->flags &= ~wait_mask;
+      }
+      wait_queue_wake_thread(&event->waiters, thread, WAIT_OK);
+    }
+  }
+
+  uint32_t flags = event->flags;
+  restore_interrupt_state(state);
+  return flags;
+}
+
+/**
+ * @brief Clears flags.
+ *
+ * @param[in] event The group.
+ * @param[in] mask Flags to clear.
+ * @return The flags left set.
+ */
+uint32_t sys_event_clear(kevent_t *event, uint32_t mask){
+  int state = save_interrupt_state_and_disable();
+  event->flags &= ~mask;
+  uint32_t flags = event->flags;
+  restore_interrupt_state(state);
+  return flags;
+}
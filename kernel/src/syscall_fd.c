@@ -0,0 +1,332 @@
+/**
+ * @file syscall_fd.c
+ *
+ * @brief File descriptor table and the devices behind it: the UART
+ *        console, the LCD, the keypad, the trace text sink and a null
+ *        device.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <syscall_fd.h>
+#include <syscall_thread.h>
+#include <kernel_config.h>
+#include <uart.h>
+#include <printk.h>
+#include <i2c.h>
+#include <lcd_driver.h>
+#include <keypad_driver.h>
+#include <itm.h>
+#include <klog.h>
+
+/**
+ * @brief Operation of devices that cannot be read.
+ *
+ * @return -1 always.
+ */
+static int fd_dev_no_read(char *buf, int len){
+  (void)buf;
+  (void)len;
+  return -1;
+}
+
+/**
+ * @brief Operation of devices that cannot be written.
+ *
+ * @return -1 always.
+ */
+static int fd_dev_no_write(const char *buf, int len){
+  (void)buf;
+  (void)len;
+  return -1;
+}
+
+/**
+ * @brief Writes to the UART. It blocks until all bytes are queued, with
+ *        the calling thread asleep while the transmit ring is full.
+ *
+ * @param[in] buf The bytes.
+ * @param[in] len Number of bytes.
+ * @return len.
+ */
+static int uart_dev_write(const char *buf, int len){
+  int i = 0;
+  while (i < len){
+    int n = uart_write(buf + i, len - i);
+    if (n == 0){
+      uart_wait_writable();
+    }
+    i += n;
+  }
+  return len;
+}
+
+/**
+ * @brief Reads a line from the UART and echoes it back.
+ *
+ * Reads up to len bytes, stopping after a newline or at an end of
+ * transmission character. Backspace removes the last byte. The calling
+ * thread sleeps while no input is available.
+ *
+ * @param[out] buf Where the bytes go.
+ * @param[in] len Most bytes to read.
+ * @return Number of bytes read.
+ */
+static int uart_dev_read(char *buf, int len){
+  char c;
+  int curr_ind = 0;
+  while (curr_ind < len){
+    if (uart_get_byte(&c) < 0){
+      uart_wait_readable();
+      continue;
+    }
+
+    /* End Of Trans Character */
+    if (c == 4){ return curr_ind;}
+
+    /* Backspace Character */
+    if (c == '\b'){
+      if (curr_ind > 0){
+        curr_ind -= 1;
+      }
+      printk("\b \b");
+      continue;
+    }
+
+    buf[curr_ind] = c;
+    curr_ind ++;
+    printk("%c", c);
+
+    /* New Line */
+    if (c == '\n'){ return curr_ind;}
+  }
+  return len;
+}
+
+/**
+ * @brief Writes to the LCD, bringing up I2C1 and the display on first use.
+ *        '\n' moves to the second row and '\f' clears the display. Every
+ *        character takes a few ticks, one thread should own the LCD.
+ *
+ * @param[in] buf The characters.
+ * @param[in] len Number of characters.
+ * @return len.
+ */
+static int lcd_dev_write(const char *buf, int len){
+  static int ready;
+  char s[2] = { 0, 0 };
+
+  if (!ready){
+    i2c_master_init(0);
+    lcd_driver_init();
+    ready = 1;
+  }
+
+  for (int i = 0; i < len; i++){
+    if (buf[i] == '\f'){
+      lcd_clear();
+    }
+    else if (buf[i] == '\n'){
+      lcd_set_cursor(1, 0);
+    }
+    else {
+      s[0] = buf[i];
+      lcd_print(s);
+    }
+  }
+  return len;
+}
+
+/**
+ * @brief Waits a tick between keypad scans. The default thread cannot
+ *        sleep, it scans again at once.
+ */
+static void keypad_dev_wait(){
+  sys_sleep_for(1);
+}
+
+/**
+ * @brief Reads one key press, setting up the keypad pins on first use.
+ *        Returns once the key is released, so holding a key does not
+ *        repeat it.
+ *
+ * @param[out] buf Where the key goes.
+ * @param[in] len Most bytes to read.
+ * @return 1, 0 if len is 0.
+ */
+static int keypad_dev_read(char *buf, int len){
+  static int ready;
+  char key;
+
+  if (len <= 0){
+    return 0;
+  }
+  if (!ready){
+    keypad_init();
+    ready = 1;
+  }
+
+  while ((key = keypad_read()) == '\0'){
+    keypad_dev_wait();
+  }
+  while (keypad_read() == key){
+    keypad_dev_wait();
+  }
+  buf[0] = key;
+  return 1;
+}
+
+/**
+ * @brief Reads from the null device.
+ *
+ * @return 0, end of file.
+ */
+static int null_dev_read(char *buf, int len){
+  (void)buf;
+  (void)len;
+  return 0;
+}
+
+/**
+ * @brief Writes to the null device.
+ *
+ * @return len, everything is discarded.
+ */
+static int null_dev_write(const char *buf, int len){
+  (void)buf;
+  return len;
+}
+
+/** @brief The devices */
+//@{
+static const fd_dev_t uart_dev = { uart_dev_read, uart_dev_write, FD_DEV_TTY };
+static const fd_dev_t lcd_dev = { fd_dev_no_read, lcd_dev_write, 0 };
+static const fd_dev_t keypad_dev = { keypad_dev_read, fd_dev_no_write, 0 };
+#if ITM_TRACE
+static const fd_dev_t trace_dev = { fd_dev_no_read, itm_write, 0 };
+#else
+static const fd_dev_t trace_dev = { fd_dev_no_read, klog_write, 0 };
+#endif
+static const fd_dev_t null_dev = { null_dev_read, null_dev_write, 0 };
+//@}
+
+/**
+ * @brief Device of every file descriptor, NULL once closed.
+ */
+static const fd_dev_t *fd_table[FD_MAX] = {
+  [FD_STDIN] = &uart_dev,
+  [FD_STDOUT] = &uart_dev,
+  [FD_STDERR] = &uart_dev,
+  [FD_LCD] = &lcd_dev,
+  [FD_KEYPAD] = &keypad_dev,
+  [FD_TRACE] = &trace_dev,
+  [FD_NULL] = &null_dev,
+};
+
+/**
+ * @brief Looks up the device of a file descriptor.
+ *
+ * @param[in] file The file descriptor.
+ * @return The device, NULL if the descriptor is not open.
+ */
+static const fd_dev_t *fd_lookup(int file){
+  if ((uint32_t)file >= FD_MAX){
+    return NULL;
+  }
+  return fd_table[file];
+}
+
+/**
+ * @brief Writes to a file descriptor.
+ *
+ * @param[in] file The file descriptor.
+ * @param[in] ptr Pointer to the buffer containing the data to write.
+ * @param[in] len The number of bytes to write.
+ * @return The number of bytes written on success, or -1 if the file
+ *         descriptor is not open or cannot be written.
+ */
+int sys_write(int file, char *ptr, int len){
+  const fd_dev_t *dev = fd_lookup(file);
+  if (dev == NULL){
+    return -1;
+  }
+  return dev -> write(ptr, len);
+}
+
+/**
+ * @brief Reads from a file descriptor.
+ *
+ * @param[in] file The file descriptor.
+ * @param[out] ptr Pointer to the buffer where the input data will be stored.
+ * @param[in] len The maximum number of bytes to read.
+ * @return The number of bytes read on success, 0 at end of file, or -1 if
+ *         the file descriptor is not open or cannot be read.
+ */
+int sys_read(int file, char *ptr, int len){
+  const fd_dev_t *dev = fd_lookup(file);
+  if (dev == NULL){
+    return -1;
+  }
+  return dev -> read(ptr, len);
+}
+
+/**
+ * @brief Unbinds a file descriptor from its device.
+ *
+ * @param[in] file The file descriptor.
+ * @return 0 on success, -1 if it was not open.
+ */
+int sys_close(int file){
+  if (fd_lookup(file) == NULL){
+    return -1;
+  }
+  fd_table[file] = NULL;
+  return 0;
+}
+
+/**
+ * @brief Describes a file descriptor as a character device, which is
+ *        all newlib looks at.
+ *
+ * @param[in] file The file descriptor.
+ * @param[out] st A newlib struct stat.
+ * @return 0 on success, -1 if the descriptor is not open.
+ */
+int sys_fstat(int file, void *st){
+  if (fd_lookup(file) == NULL){
+    return -1;
+  }
+
+  struct stat *s = st;
+  *s = (struct stat){ 0 };
+  s -> st_mode = S_IFCHR;
+  return 0;
+}
+
+/**
+ * @brief Whether a file descriptor is a terminal. newlib line buffers
+ *        terminals and fully buffers everything else.
+ *
+ * @param[in] file The file descriptor.
+ * @return 1 for the UART console, 0 otherwise.
+ */
+int sys_isatty(int file){
+  const fd_dev_t *dev = fd_lookup(file);
+  return dev != NULL && (dev -> flags & FD_DEV_TTY) != 0;
+}
+
+/**
+ * @brief Moves the file offset. Every device is a stream.
+ *
+ * @return -1 always.
+ */
+int sys_lseek(int file, int offset, int whence){
+  (void)file;
+  (void)offset;
+  (void)whence;
+  return -1;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file syscall_msgq.c
+ *
+ * @brief Zero-copy message queues. Senders reserve a block, fill it in place
+ *        and commit it; receivers borrow the oldest block and release it
+ *        when done. Only block indices move through the kernel.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_msgq.h>
+#include <wait_queue.h>
+#include <arm.h>
+
+/**
+ * @brief global array for storing message queue information
+ */
+kmsgq_t msgq_array[MAX_MSGQS];
+
+/**
+ * @brief index of the next free queue in msgq_array
+ */
+static uint32_t msgq_index;
+
+/**
+ * @brief Turns a user block pointer back into a block index.
+ *
+ * @param[in] q The queue.
+ * @param[in] block Address of the block.
+ * @return The block index, -1 if the address is not a block of q.
+ */
+static int msgq_block_index(kmsgq_t *q, void *block){
+  uint32_t offset = (char *)block - q->buffer;
+  if ((char *)block < q->buffer || offset % q->block_size != 0){
+    return -1;
+  }
+  uint32_t i = offset / q->block_size;
+  if (i >= q->num_blocks){
+    return -1;
+  }
+  return i;
+}
+
+/**
+ * @brief Takes the lowest free block and updates the high-water mark.
+ *
+ * @param[in] q The queue, must have a free block.
+ * @return The block index.
+ */
+static uint32_t msgq_take_free(kmsgq_t *q){
+  uint32_t i = __builtin_ctz(q->free_bitmap);
+  q->free_bitmap &= ~(1 << i);
+
+  uint32_t in_use = q->num_blocks - __builtin_popcount(q->free_bitmap);
+  if (in_use > q->high_water){
+    q->high_water = in_use;
+  }
+  return i;
+}
+
+/**
+ * @brief Resets every queue in the global message queue array.
+ */
+void initialize_msgq_array(){
+  for (uint32_t i = 0; i < MAX_MSGQS; i++){
+    msgq_array[i].buffer = NULL;
+    msgq_array[i].index = i;
+    wait_queue_init(&msgq_array[i].send_waiters);
+    wait_queue_init(&msgq_array[i].recv_waiters);
+  }
+  msgq_index = 0;
+}
+
+/**
+ * @brief Hands out the next free message queue.
+ *
+ * @param[in] buffer User block storage.
+ * @param[in] block_size Size of a block.
+ * @param[in] num_blocks Number of blocks.
+ * @return Pointer to the queue, NULL on failure.
+ */
+kmsgq_t *sys_msgq_init(void *buffer, uint32_t block_size, uint32_t num_blocks){
+  if (msgq_index >= MAX_MSGQS || buffer == NULL || block_size == 0 ||
+      num_blocks == 0 || num_blocks > MSGQ_MAX_BLOCKS){
+    return NULL;
+  }
+
+  kmsgq_t *q = &msgq_array[msgq_index];
+  q->buffer = buffer;
+  q->block_size = block_size;
+  q->num_blocks = num_blocks;
+  q->free_bitmap = (num_blocks == 32) ? 0xFFFFFFFF : ((1U << num_blocks) - 1);
+  q->reserved_bitmap = 0;
+  q->borrowed_bitmap = 0;
+  q->fifo_head = 0;
+  q->fifo_count = 0;
+  q->high_water = 0;
+  wait_queue_init(&q->send_waiters);
+  wait_queue_init(&q->recv_waiters);
+  msgq_index++;
+
+  return q;
+}
+
+/**
+ * @brief Reserves a free block, sleeping until one is released if needed.
+ *
+ * A thread woken by sys_msgq_release() is handed the released block index
+ * as its wait status.
+ *
+ * @param[in] q The queue.
+ * @param[out] block Address of the reserved block.
+ * @param[in] timeout Ticks to wait at most.
+ * @return 0 on success, WAIT_TIMEOUT or -1 on failure.
+ */
+int sys_msgq_reserve(kmsgq_t *q, void **block, uint32_t timeout){
+  int state = save_interrupt_state_and_disable();
+  int32_t i;
+
+  if (q->free_bitmap != 0){
+    i = msgq_take_free(q);
+    q->reserved_bitmap |= (1 << i);
+    restore_interrupt_state(state);
+  }
+  else {
+    int err = wait_queue_enqueue(&q->send_waiters, timeout);
+    restore_interrupt_state(state);
+    if (err < 0){
+      return err;
+    }
+    i = wait_queue_sleep();
+    if (i < 0){
+      return i;
+    }
+  }
+
+  *block = q->buffer + i * q->block_size;
+  return 0;
+}
+
+/**
+ * @brief Appends a reserved block to the queue, or hands it straight to the
+ *        highest priority receiver waiting for one.
+ *
+ * @param[in] q The queue.
+ * @param[in] block The reserved block.
+ * @return 0 on success, -1 if the block is not reserved.
+ */
+int sys_msgq_commit(kmsgq_t *q, void *block){
+  int i = msgq_block_index(q, block);
+  if (i < 0){
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+
+  if (!(q->reserved_bitmap & (1 << i))){
+    restore_interrupt_state(state);
+    return -1;
+  }
+  q->reserved_bitmap &= ~(1 << i);
+
+  if (q->recv_waiters.waiters != 0){
+    q->borrowed_bitmap |= (1 << i);
+    wait_queue_wake_one(&q->recv_waiters, i);
+  }
+  else {
+    q->fifo[(q->fifo_head + q->fifo_count) % MSGQ_MAX_BLOCKS] = i;
+    q->fifo_count++;
+  }
+
+  restore_interrupt_state(state);
+  return 0;
+}
+
+/**
+ * @brief Borrows the oldest committed block, sleeping until one is
+ *        committed if the queue is empty.
+ *
+ * @param[in] q The queue.
+ * @param[out] block Address of the borrowed block.
+ * @param[in] timeout Ticks to wait at most.
+ * @return 0 on success, WAIT_TIMEOUT or -1 on failure.
+ */
+int sys_msgq_receive(kmsgq_t *q, void **block, uint32_t timeout){
+  int state = save_interrupt_state_and_disable();
+  int32_t i;
+
+  if (q->fifo_count != 0){
+    i = q->fifo[q->fifo_head];
+    q->fifo_head = (q->fifo_head + 1) % MSGQ_MAX_BLOCKS;
+    q->fifo_count--;
+    q->borrowed_bitmap |= (1 << i);
+    restore_interrupt_state(state);
+  }
+  else {
+    int err = wait_queue_enqueue(&q->recv_waiters, timeout);
+    restore_interrupt_state(state);
+    if (err < 0){
+      return err;
+    }
+    i = wait_queue_sleep();
+    if (i < 0){
+      return i;
+    }
+  }
+
+  *block = q->buffer + i * q->block_size;
+  return 0;
+}
+
+/**
+ * @brief Gives a borrowed block back, or hands it straight to the highest
+ *        priority sender waiting for a free block.
+ *
+ * @param[in] q The queue.
+ * @param[in] block The borrowed block.
+ * @return 0 on success, -1 if the block is not borrowed.
+ */
+int sys_msgq_release(kmsgq_t *q, void *block){
+  int i = msgq_block_index(q, block);
+  if (i < 0){
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+
+  if (!(q->borrowed_bitmap & (1 << i))){
+    restore_interrupt_state(state);
+    return -1;
+  }
+  q->borrowed_bitmap &= ~(1 << i);
+
+  if (q->send_waiters.waiters != 0){
+    q->reserved_bitmap |= (1 << i);
+    wait_queue_wake_one(&q->send_waiters, i);
+  }
+  else {
+    q->free_bitmap |= (1 << i);
+  }
+
+  restore_interrupt_state(state);
+  return 0;
+}
+
+/**
+ * @brief Returns the queue's high-water mark.
+ *
+ * @param[in] q The queue.
+ * @return Most blocks ever out of the free pool at once.
+ */
+uint32_t sys_msgq_high_water(kmsgq_t *q){
+  return q->high_water;
+}
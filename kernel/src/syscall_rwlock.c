@@ -0,0 +1,344 @@
+/**
+ * @file syscall_rwlock.c
+ *
+ * @brief Reader-writer locks with separate read and write priority ceilings.
+ *        Waiting readers and writers are served in priority order, and a
+ *        release hands the lock straight to the threads it admits.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_rwlock.h>
+#include <syscall_thread.h>
+#include <wait_queue.h>
+#include <printk.h>
+#include <arm.h>
+
+/** @brief Value of writer when no thread holds the write lock. */
+#define RWLOCK_FREE 0xFFFFFFFF
+
+/** @brief Index past the lowest priority thread, for empty bitmaps. */
+#define NO_THREAD 32
+
+/**
+ * @brief global array for storing reader-writer lock information
+ */
+krwlock_t rwlock_array[MAX_RWLOCKS];
+
+/**
+ * @brief index of the next free lock in rwlock_array
+ */
+static uint32_t rwlock_index;
+
+/**
+ * @brief Highest priority thread in a bitmap.
+ *
+ * @param[in] bitmap Thread bitmap.
+ * @return The thread index, NO_THREAD if the bitmap is empty.
+ */
+static uint32_t first_thread(uint32_t bitmap){
+  return bitmap ? (uint32_t)__builtin_ctz(bitmap) : NO_THREAD;
+}
+
+/**
+ * @brief Raises a thread to a ceiling if it runs below it.
+ *
+ * @param[in] thread The thread.
+ * @param[in] ceil The ceiling.
+ */
+static void raise_to_ceiling(uint32_t thread, uint32_t ceil){
+  if (TCB_ARRAY[thread].priority > ceil){
+    TCB_ARRAY[thread].priority = ceil;
+  }
+}
+
+/**
+ * @brief Admits waiters after the lock state changed. Must be called with
+ *        interrupts disabled.
+ *
+ * A writer is admitted when the lock is free and it outranks every waiting
+ * reader. Otherwise every waiting reader that outranks the first waiting
+ * writer is admitted, so readers never overtake a higher priority writer.
+ *
+ * @param[in] rw The lock.
+ */
+static void rwlock_admit(krwlock_t *rw){
+  if (rw->writer != RWLOCK_FREE){
+    return;
+  }
+
+  uint32_t first_writer = first_thread(rw->write_waiters.waiters);
+  uint32_t first_reader = first_thread(rw->read_waiters.waiters);
+
+  if (first_writer < first_reader){
+    if (rw->readers == 0){
+      rw->writer = first_writer;
+      raise_to_ceiling(first_writer, rw->write_ceil);
+      wait_queue_wake_thread(&rw->write_waiters, first_writer, WAIT_OK);
+    }
+    return;
+  }
+
+  uint32_t admit = rw->read_waiters.waiters;
+  if (first_writer != NO_THREAD){
+    admit &= (1U << first_writer) - 1;
+  }
+  while (admit != 0){
+    uint32_t reader = __builtin_ctz(admit);
+    admit &= ~(1U << reader);
+    rw->readers |= (1U << reader);
+    raise_to_ceiling(reader, rw->read_ceil);
+    wait_queue_wake_thread(&rw->read_waiters, reader, WAIT_OK);
+  }
+}
+
+/**
+ * @brief Resets every lock in the global reader-writer lock array.
+ */
+void initialize_rwlock_array(){
+  for (uint32_t i = 0; i < MAX_RWLOCKS; i++){
+    rwlock_array[i].writer = RWLOCK_FREE;
+    rwlock_array[i].readers = 0;
+    rwlock_array[i].index = i;
+    for (uint32_t j = 0; j < 16; j++){
+      rwlock_array[i].read_cs_length[j] = 0;
+      rwlock_array[i].write_cs_length[j] = 0;
+    }
+    wait_queue_init(&rwlock_array[i].read_waiters);
+    wait_queue_init(&rwlock_array[i].write_waiters);
+  }
+  rwlock_index = 0;
+}
+
+/**
+ * @brief Hands out the next free reader-writer lock.
+ *
+ * @param[in] read_ceil Priority of the highest priority writer.
+ * @param[in] write_ceil Priority of the highest priority user.
+ * @return Pointer to the lock, NULL on failure.
+ */
+krwlock_t *sys_rwlock_init(uint32_t read_ceil, uint32_t write_ceil){
+  if (rwlock_index >= MAX_RWLOCKS || write_ceil > read_ceil){
+    return NULL;
+  }
+
+  krwlock_t *rw = &rwlock_array[rwlock_index];
+  rw->read_ceil = read_ceil;
+  rw->write_ceil = write_ceil;
+  rwlock_index++;
+
+  return rw;
+}
+
+/**
+ * @brief Checks that the current thread may take the lock at all.
+ *
+ * @param[in] rw The lock.
+ * @return The current thread, or -1 if it may not take the lock.
+ */
+static int rwlock_check_caller(krwlock_t *rw){
+  uint32_t current_thread = global_threads_info.current_thread;
+
+  if (current_thread >= global_threads_info.max_threads){
+    return -1;
+  }
+
+  // Same rule as mutexes: a thread above the ceiling breaks IPCP
+  if (current_thread < rw->write_ceil){
+    printk("Warning: Thread %d cannot lock rwlock %d because its priority is above the ceiling %d\n",
+           current_thread, rw->index, rw->write_ceil);
+    sys_thread_kill();
+    return -1;
+  }
+
+  if (rw->writer == current_thread || (rw->readers & (1U << current_thread))){
+    printk("Warning: Thread %d is trying to lock rwlock %d again\n", current_thread, rw->index);
+    return -1;
+  }
+
+  return current_thread;
+}
+
+/**
+ * @brief Takes the lock for reading.
+ *
+ * A reader gets in as long as there is no writer holding the lock and no
+ * higher priority writer waiting for it.
+ *
+ * @param[in] rw The lock.
+ * @param[in] timeout Ticks to wait at most, WAIT_FOREVER for no limit.
+ * @return 0 on success, WAIT_TIMEOUT if the timeout expired, -1 on misuse.
+ */
+int sys_rwlock_read_lock(krwlock_t *rw, uint32_t timeout){
+  int caller = rwlock_check_caller(rw);
+  if (caller < 0){
+    return -1;
+  }
+  uint32_t current_thread = caller;
+
+  int state = save_interrupt_state_and_disable();
+
+  if (rw->writer == RWLOCK_FREE && first_thread(rw->write_waiters.waiters) > current_thread){
+    rw->readers |= (1U << current_thread);
+    raise_to_ceiling(current_thread, rw->read_ceil);
+    restore_interrupt_state(state);
+    return 0;
+  }
+
+  int err = wait_queue_enqueue(&rw->read_waiters, timeout);
+  restore_interrupt_state(state);
+  if (err < 0){
+    return err;
+  }
+  return wait_queue_sleep();
+}
+
+/**
+ * @brief Takes the lock for writing.
+ *
+ * @param[in] rw The lock.
+ * @param[in] timeout Ticks to wait at most, WAIT_FOREVER for no limit.
+ * @return 0 on success, WAIT_TIMEOUT if the timeout expired, -1 on misuse.
+ */
+int sys_rwlock_write_lock(krwlock_t *rw, uint32_t timeout){
+  int caller = rwlock_check_caller(rw);
+  if (caller < 0){
+    return -1;
+  }
+  uint32_t current_thread = caller;
+
+  int state = save_interrupt_state_and_disable();
+
+  if (rw->writer == RWLOCK_FREE && rw->readers == 0){
+    rw->writer = current_thread;
+    raise_to_ceiling(current_thread, rw->write_ceil);
+    restore_interrupt_state(state);
+    return 0;
+  }
+
+  int err = wait_queue_enqueue(&rw->write_waiters, timeout);
+  restore_interrupt_state(state);
+  if (err < 0){
+    return err;
+  }
+
+  int32_t status = wait_queue_sleep();
+  if (status == WAIT_TIMEOUT){
+    // Readers queued behind this writer only waited because of it
+    state = save_interrupt_state_and_disable();
+    rwlock_admit(rw);
+    restore_interrupt_state(state);
+  }
+  return status;
+}
+
+/**
+ * @brief Releases the caller's hold on the lock and admits waiters.
+ *
+ * @param[in] rw The lock.
+ * @return 0 on success, -1 if the caller does not hold the lock.
+ */
+int sys_rwlock_unlock(krwlock_t *rw){
+  uint32_t current_thread = global_threads_info.current_thread;
+  int state = save_interrupt_state_and_disable();
+
+  if (rw->writer == current_thread){
+    rw->writer = RWLOCK_FREE;
+  }
+  else if (rw->readers & (1U << current_thread)){
+    rw->readers &= ~(1U << current_thread);
+  }
+  else {
+    restore_interrupt_state(state);
+    printk("Warning: Thread %d is trying to unlock rwlock %d that it does not hold\n", current_thread, rw->index);
+    return -1;
+  }
+
+  rwlock_admit(rw);
+  thread_update_priority(current_thread);
+  restore_interrupt_state(state);
+
+  pend_pendsv();
+  return 0;
+}
+
+/**
+ * @brief Declares the longest read and write sections of a thread.
+ *
+ * @param[in] rw The lock.
+ * @param[in] prio The thread.
+ * @param[in] read_ticks Longest read section.
+ * @param[in] write_ticks Longest write section.
+ * @return 0 on success, -1 on invalid arguments or if the UB test fails.
+ */
+int sys_rwlock_declare(krwlock_t *rw, uint32_t prio, uint32_t read_ticks, uint32_t write_ticks){
+  if (prio >= global_threads_info.max_threads || prio < rw->write_ceil ||
+      (write_ticks != 0 && prio < rw->read_ceil)){
+    printk("Warning: Thread %d does not fit the ceilings of rwlock %d\n", prio, rw->index);
+    return -1;
+  }
+
+  uint32_t old_read = rw->read_cs_length[prio];
+  uint32_t old_write = rw->write_cs_length[prio];
+  rw->read_cs_length[prio] = read_ticks;
+  rw->write_cs_length[prio] = write_ticks;
+  if (ub_test(-1, 0, 0) < 0){
+    rw->read_cs_length[prio] = old_read;
+    rw->write_cs_length[prio] = old_write;
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Highest ceiling among the locks a thread holds.
+ *
+ * @param[in] thread The thread.
+ * @param[in] priority Priority to start from.
+ * @return The smaller of priority and the held ceilings.
+ */
+uint32_t rwlock_held_ceiling(uint32_t thread, uint32_t priority){
+  for (uint32_t i = 0; i < rwlock_index; i++){
+    if (rwlock_array[i].writer == thread && rwlock_array[i].write_ceil < priority){
+      priority = rwlock_array[i].write_ceil;
+    }
+    if ((rwlock_array[i].readers & (1U << thread)) && rwlock_array[i].read_ceil < priority){
+      priority = rwlock_array[i].read_ceil;
+    }
+  }
+  return priority;
+}
+
+/**
+ * @brief Blocking term contributed by reader-writer locks.
+ *
+ * A lower priority writer runs at the write ceiling, so it can block every
+ * thread at or below that ceiling. A lower priority reader only runs at the
+ * read ceiling, so threads above it (the other readers) are never blocked
+ * by it.
+ *
+ * @param[in] index The thread that may be blocked.
+ * @param[in] lower Bitmap of the existing lower priority threads.
+ * @return The longest section that can block the thread.
+ */
+uint32_t rwlock_blocking_term(uint32_t index, uint32_t lower){
+  uint32_t blocking = 0;
+  for (uint32_t i = 0; i < rwlock_index; i++){
+    krwlock_t *rw = &rwlock_array[i];
+    uint32_t pending = lower;
+    while (pending != 0){
+      uint32_t thread = __builtin_ctz(pending);
+      pending &= ~(1U << thread);
+      if (rw->write_ceil <= index && rw->write_cs_length[thread] > blocking){
+        blocking = rw->write_cs_length[thread];
+      }
+      if (rw->read_ceil <= index && rw->read_cs_length[thread] > blocking){
+        blocking = rw->read_cs_length[thread];
+      }
+    }
+  }
+  return blocking;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file syscall_sem.c
+ *
+ * @brief Counting semaphores. Waiters sleep on a wait queue instead of
+ *        spinning, and a post hands the unit straight to the highest
+ *        priority waiter.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_sem.h>
+#include <wait_queue.h>
+#include <arm.h>
+
+/**
+ * @brief global array for storing semaphore information
+ */
+ksem_t sem_array[MAX_SEMAPHORES];
+
+/**
+ * @brief index of the next free semaphore in sem_array
+ */
+static uint32_t sem_index;
+
+/**
+ * @brief Resets every semaphore in the global semaphore array.
+ */
+void initialize_sem_array(){
+  for (uint32_t i = 0; i < MAX_SEMAPHORES; i++){
+    sem_array[i].count = 0;
+    sem_array[i].max_count = 0;
+    sem_array[i].index = i;
+    wait_queue_init(&sem_array[i].waiters);
+  }
+  sem_index = 0;
+}
+
+/**
+ * @brief Hands out the next free semaphore.
+ *
+ * @param[in] count Initial count.
+ * @param[in] max_count Maximum count.
+ * @return Pointer to the semaphore, NULL on failure.
+ */
+ksem_t *sys_sem_init(uint32_t count, uint32_t max_count){
+  if (sem_index >= MAX_SEMAPHORES || max_count == 0 || count > max_count){
+    return NULL;
+  }
+
+  ksem_t *sem = &sem_array[sem_index];
+  sem->count = count;
+  sem->max_count = max_count;
+  wait_queue_init(&sem->waiters);
+  sem_index++;
+
+  return sem;
+}
+
+/**
+ * @brief Takes a unit from the semaphore, sleeping while the count is 0.
+ *
+ * @param[in] sem The semaphore.
+ * @return 0 on success, -1 if the thread could not block.
+ */
+int sys_sem_wait(ksem_t *sem){
+  return sys_sem_wait_timed(sem, WAIT_FOREVER);
+}
+
+/**
+ * @brief Takes a unit from the semaphore, sleeping at most timeout ticks
+ *        while the count is 0.
+ *
+ * A thread woken by sys_sem_post() already owns the unit that was posted, so
+ * there is no need to re-check the count afterwards.
+ *
+ * @param[in] sem The semaphore.
+ * @param[in] timeout Ticks to wait at most, WAIT_FOREVER for no limit.
+ * @return 0 on success, WAIT_TIMEOUT if the timeout expired, -1 if the
+ *         thread could not block.
+ */
+int sys_sem_wait_timed(ksem_t *sem, uint32_t timeout){
+  int state = save_interrupt_state_and_disable();
+
+  if (sem->count > 0){
+    sem->count--;
+    restore_interrupt_state(state);
+    return 0;
+  }
+
+  int err = wait_queue_enqueue(&sem->waiters, timeout);
+  if (err < 0){
+    restore_interrupt_state(state);
+    return err;
+  }
+
+  restore_interrupt_state(state);
+  return wait_queue_sleep();
+}
+
+/**
+ * @brief Takes a unit from the semaphore if there is one.
+ *
+ * @param[in] sem The semaphore.
+ * @return 0 on success, -1 if the count was 0.
+ */
+int sys_sem_try_wait(ksem_t *sem){
+  int state = save_interrupt_state_and_disable();
+  int ret = -1;
+
+  if (sem->count > 0){
+    sem->count--;
+    ret = 0;
+  }
+
+  restore_interrupt_state(state);
+  return ret;
+}
+
+/**
+ * @brief Releases a unit. Callable from thread (SVC) or interrupt context.
+ *
+ * @param[in] sem The semaphore.
+ * @return 0 on success, -1 if the semaphore is already full.
+ */
+int sys_sem_post(ksem_t *sem){
+  int state = save_interrupt_state_and_disable();
+  int ret = 0;
+
+  if (wait_queue_wake_one(&sem->waiters, WAIT_OK) < 0){
+    if (sem->count < sem->max_count){
+      sem->count++;
+    }
+    else {
+      ret = -1;
+    }
+  }
+
+  restore_interrupt_state(state);
+  return ret;
+}
@@ -0,0 +1,288 @@
+/**
+ * @file syscall_swtimer.c
+ *
+ * @brief Software timers on a hashed timer wheel. SysTick advances the wheel
+ *        one slot per tick; expired timers are unlinked (and periodic ones
+ *        re-linked) with interrupts disabled and fired afterwards, so
+ *        callbacks may re-arm or cancel timers themselves.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <syscall_swtimer.h>
+#include <syscall_event.h>
+#include <systick.h>
+#include <wait_queue.h>
+#include <arm.h>
+
+/**
+ * @brief global array for storing timer information
+ */
+kswtimer_t swtimer_array[MAX_SWTIMERS];
+
+/**
+ * @brief index of the next free timer in swtimer_array
+ */
+static uint32_t swtimer_index;
+
+/**
+ * @brief the timer wheel, each slot is the head of a doubly linked list
+ */
+static kswtimer_t *wheel[SWTIMER_WHEEL_SLOTS];
+
+/**
+ * @brief Resets every timer and empties the wheel.
+ */
+void initialize_swtimer_array(){
+  for (uint32_t i = 0; i < MAX_SWTIMERS; i++){
+    swtimer_array[i].next = NULL;
+    swtimer_array[i].prev = NULL;
+    swtimer_array[i].fire_next = NULL;
+    swtimer_array[i].armed = 0;
+    swtimer_array[i].pending = 0;
+    swtimer_array[i].index = i;
+    wait_queue_init(&swtimer_array[i].waiters);
+  }
+  for (uint32_t i = 0; i < SWTIMER_WHEEL_SLOTS; i++){
+    wheel[i] = NULL;
+  }
+  swtimer_index = 0;
+}
+
+/**
+ * @brief Puts a timer on the wheel slot of its expiry. Must be called with
+ *        interrupts disabled.
+ *
+ * @param[in] timer The timer.
+ */
+static void swtimer_link(kswtimer_t *timer){
+  kswtimer_t **slot = &wheel[timer->expiry & (SWTIMER_WHEEL_SLOTS - 1)];
+  timer->prev = NULL;
+  timer->next = *slot;
+  if (*slot != NULL){
+    (*slot)->prev = timer;
+  }
+  *slot = timer;
+  timer->armed = 1;
+}
+
+/**
+ * @brief Takes a timer off the wheel. Must be called with interrupts
+ *        disabled.
+ *
+ * @param[in] timer The timer.
+ */
+static void swtimer_unlink(kswtimer_t *timer){
+  if (timer->prev != NULL){
+    timer->prev->next = timer->next;
+  }
+  else {
+    wheel[timer->expiry & (SWTIMER_WHEEL_SLOTS - 1)] = timer->next;
+  }
+  if (timer->next != NULL){
+    timer->next->prev = timer->prev;
+  }
+  timer->next = NULL;
+  timer->prev = NULL;
+  timer->armed = 0;
+}
+
+/**
+ * @brief Hands out the next free timer.
+ *
+ * @param[in] target What the timer does on expiry.
+ * @return Pointer to the timer, NULL if none are left.
+ */
+static kswtimer_t *swtimer_alloc(uint32_t target){
+  int state = save_interrupt_state_and_disable();
+  if (swtimer_index >= MAX_SWTIMERS){
+    restore_interrupt_state(state);
+    return NULL;
+  }
+  kswtimer_t *timer = &swtimer_array[swtimer_index];
+  swtimer_index++;
+  restore_interrupt_state(state);
+
+  timer->target = target;
+  timer->period = 0;
+  timer->pending = 0;
+  timer->event = NULL;
+  timer->mask = 0;
+  timer->fn = NULL;
+  timer->arg = NULL;
+  return timer;
+}
+
+/**
+ * @brief Creates a timer that wakes waiters or sets event flags.
+ *
+ * @param[in] event Event to set, NULL to wake waiters.
+ * @param[in] mask Flags to set on the event.
+ * @return Pointer to the timer, NULL on failure.
+ */
+kswtimer_t *sys_swtimer_create(kevent_t *event, uint32_t mask){
+  kswtimer_t *timer = swtimer_alloc(event == NULL ? SWTIMER_WAKE : SWTIMER_EVENT);
+  if (timer != NULL){
+    timer->event = event;
+    timer->mask = mask;
+  }
+  return timer;
+}
+
+/**
+ * @brief Creates a timer that runs a kernel callback.
+ *
+ * @param[in] fn Function to run.
+ * @param[in] arg Argument for fn.
+ * @return Pointer to the timer, NULL on failure.
+ */
+kswtimer_t *swtimer_create_callback(swtimer_fn_t fn, void *arg){
+  if (fn == NULL){
+    return NULL;
+  }
+  kswtimer_t *timer = swtimer_alloc(SWTIMER_CALLBACK);
+  if (timer != NULL){
+    timer->fn = fn;
+    timer->arg = arg;
+  }
+  return timer;
+}
+
+/**
+ * @brief Arms or re-arms a timer.
+ *
+ * @param[in] timer The timer.
+ * @param[in] delay Ticks until the first expiry.
+ * @param[in] period Ticks between later expiries, 0 for one-shot.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int sys_swtimer_start(kswtimer_t *timer, uint32_t delay, uint32_t period){
+  if (delay == 0){
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+  if (timer->armed){
+    swtimer_unlink(timer);
+  }
+  timer->expiry = systick_get_ticks() + delay;
+  timer->period = period;
+  timer->pending = 0;
+  swtimer_link(timer);
+  restore_interrupt_state(state);
+  return 0;
+}
+
+/**
+ * @brief Disarms a timer.
+ *
+ * @param[in] timer The timer.
+ * @return 1 if it was armed, 0 otherwise.
+ */
+int sys_swtimer_cancel(kswtimer_t *timer){
+  int state = save_interrupt_state_and_disable();
+  int was_armed = timer->armed;
+  if (was_armed){
+    swtimer_unlink(timer);
+  }
+  timer->pending = 0;
+  restore_interrupt_state(state);
+  return was_armed;
+}
+
+/**
+ * @brief Sleeps until a SWTIMER_WAKE timer expires.
+ *
+ * Expirations with nobody waiting are counted, so a periodic thread-like
+ * loop around this never misses one.
+ *
+ * @param[in] timer The timer.
+ * @param[in] timeout Ticks to wait at most.
+ * @return Expirations consumed, WAIT_TIMEOUT on timeout, -1 on misuse.
+ */
+int sys_swtimer_wait(kswtimer_t *timer, uint32_t timeout){
+  if (timer->target != SWTIMER_WAKE){
+    return -1;
+  }
+
+  int state = save_interrupt_state_and_disable();
+  uint32_t pending = timer->pending;
+  if (pending != 0){
+    timer->pending = 0;
+    restore_interrupt_state(state);
+    return pending;
+  }
+
+  int err = wait_queue_enqueue(&timer->waiters, timeout);
+  restore_interrupt_state(state);
+  if (err < 0){
+    return err;
+  }
+
+  int32_t status = wait_queue_sleep();
+  return status == WAIT_OK ? 1 : status;
+}
+
+/**
+ * @brief Runs the action of an expired timer.
+ *
+ * @param[in] timer The timer.
+ */
+static void swtimer_fire(kswtimer_t *timer){
+  switch (timer->target){
+    case SWTIMER_WAKE:
+      if (wait_queue_wake_all(&timer->waiters, WAIT_OK) == 0){
+        timer->pending++;
+      }
+    break;
+    case SWTIMER_EVENT:
+      sys_event_set(timer->event, timer->mask);
+    break;
+    case SWTIMER_CALLBACK:
+      timer->fn(timer->arg);
+    break;
+    default:
+    break;
+  }
+}
+
+/**
+ * @brief Advances the wheel to now.
+ *
+ * Only the slot of now is looked at. Timers in it that belong to a later
+ * turn of the wheel stay where they are.
+ *
+ * @param[in] now The current tick count.
+ */
+void swtimer_tick(uint32_t now){
+  kswtimer_t *fire = NULL;
+  kswtimer_t **fire_tail = &fire;
+
+  int state = save_interrupt_state_and_disable();
+  kswtimer_t *timer = wheel[now & (SWTIMER_WHEEL_SLOTS - 1)];
+  while (timer != NULL){
+    kswtimer_t *next = timer->next;
+    if (timer->expiry == now){
+      swtimer_unlink(timer);
+      if (timer->period != 0){
+        //relinked at the head of another turn, so this walk never sees it again
+        timer->expiry = now + timer->period;
+        swtimer_link(timer);
+      }
+      timer->fire_next = NULL;
+      *fire_tail = timer;
+      fire_tail = &timer->fire_next;
+    }
+    timer = next;
+  }
+  restore_interrupt_state(state);
+
+  while (fire != NULL){
+    kswtimer_t *next = fire->fire_next;
+    swtimer_fire(fire);
+    fire = next;
+  }
+}
@@ -10,11 +10,25 @@
  #include <stdint.h>
  #include "syscall_thread.h"
  #include "syscall_mutex.h"
+ #include "syscall_sem.h"
+ #include "syscall_event.h"
+ #include "syscall_msgq.h"
+ #include "syscall_rwlock.h"
+ #include "syscall_barrier.h"
+ #include "syscall_cond.h"
+ #include "syscall_swtimer.h"
+ #include "wait_queue.h"
+ #include "kernel_config.h"
+ #include "mutex_profile.h"
+ #include "dwt.h"
+ #include "itm.h"
+ #include "sched_trace.h"
  #include <arm.h>
  #include <mpu.h>
  #include <systick.h>
  #include <syscall.h>
  #include <printk.h>
+ #include <uart.h>
  
  /** @brief      Initial XPSR value, all 0s except thumb bit. */
  #define XPSR_INIT 0x1000000
@@ -70,83 +84,6 @@
     uint32_t xPSR; /**< Program status register (PSR). */
   } interrupt_stack_frame;
  
- /**
-  * @struct global_threads_info_t
-  * @brief Global thread information for tracking timing, priorities, and stack limits.
-  */
- typedef struct global_threads_info 
- {
-     uint32_t max_threads;   /**< Maximum number of threads. */
-     uint32_t max_mutexes;   /**< Maximum number of mutexes. */
-     uint32_t stack_size;    /**< Size of stack in words. */
-     uint32_t tick_counter;  /**< System tick counter. */
-     uint32_t current_thread;  /**< Index of the currently running thread. */
- 
-     uint32_t thread_time_left_in_C[16]; /**< Remaining computation time for each thread. */
-     uint32_t thread_time_left_in_T[16]; /**< Remaining period time for each thread. */
-     uint32_t thread_time[16]; /**< Absolute start time for each thread. */
- 
-     uint32_t ready_threads[16];  /**< Array of ready threads. */
-     uint32_t waiting_threads[16]; /**< Array of waiting threads. */
-     uint32_t mutex_index;
-   } global_threads_info_t;
- 
- /**
-  * @enum thread_state_t
-  * @brief Enumeration of thread states.
-  */
- typedef enum thread_state{
-      NEW, //process created
-      READY, //process ready to run
-      RUNNING, //process running
-      WAITING, //process waiting for event
-      DONE, //Exit
-      BLOCKED //process blocked by mutex
- } thread_state_t;
- 
- /**
-  * @struct pushed_callee_stack_frame
-  * @brief Stack frame pushed onto MSP before initiating a context switch.
-  */
- /* Stack frame pushed onto MSP before intiating context switch */
- typedef struct {
-    uint32_t *PSP;   /**< Pointer to the thread's Process Stack Pointer (PSP). */
-    uint32_t r4;    /**< Register value for r4 */
-    uint32_t r5;    /**< General-purpose register R5. */
-    uint32_t r6;    /**< General-purpose register R6. */
-    uint32_t r7;    /**< General-purpose register R7. */
-    uint32_t r8;    /**< General-purpose register R8. */
-    uint32_t r9;    /**< General-purpose register R9. */
-    uint32_t r10;   /**< General-purpose register R10. */
-    uint32_t r11;   /**< General-purpose register R11. */
-    uint32_t lr;    /**< Link register (LR). */
- 
- } pushed_callee_stack_frame;
- 
- /**
-  * @struct TCB_t
-  * @brief Thread Control Block (TCB) structure.
-  *
-  * This structure holds the context and metadata for a thread, including
-  * its stack pointer, priority, computation time, period, and state.
-  */
- /* TCB struct that keeps track of thread main and program stack contexts and critical timing information*/
- typedef struct TCB{
-    pushed_callee_stack_frame *msp;   /**< Pointer to the thread's kernel stack. */
- 
-    uint32_t priority;                /**< Dynamic Thread priority (0-16). */
-    uint32_t computation_time;        /**< Computation time (C) in ticks. */
-    uint32_t period;                  /**< Period (T) in ticks. */
-    uint32_t svc_status;              /**< SVC status (privileged/unprivileged). */
- 
-    thread_state_t state;             /**< Current state of the thread. */
- 
-    uint32_t held_mutex_bitmap; /**< Bitmap of held mutexes. */
-    uint32_t waiting_mutex_bitmap; /**< Bitmap of waiting mutexes. */
-   
-    uint8_t processed; /**< Flag indicating if the thread has been processed in current period. */
- } TCB_t;
- 
  // Our TCB array which holds corresponding TCBs of our threads
  /** @brief Array of Thread Control Blocks (TCBs) for all threads. */
  TCB_t TCB_ARRAY[16];
@@ -156,11 +93,16 @@
  global_threads_info_t global_threads_info;
  
  #define MAX_MUTEXES 32
- #define NOT_LOCKED 0xFFFFFFFF
  /**
   * @brief global array for storing mutex information
   */
  kmutex_t mutex_array[MAX_MUTEXES];
+
+ /**
+  * @brief Wait queue the sleeping threads time out of. Nothing ever wakes it
+  *        early.
+  */
+ static wait_queue_t sleepers;
  
  
  /**
@@ -210,36 +152,93 @@ Selected thread continues execution
 
   */
  
- /* ub_test(C, T)
-   1. Computes C/T of new thread 
-   2. Computes overall utilization based on threads already created
-   3. Sums new thread utilization with old total utilization and checks against corresponding ub bound 
+ /**
+  * @brief Checks whether a thread index takes part in admission.
+  *
+  * @param[in] index Thread index.
+  * @param[in] candidate Index of the thread being admitted, -1 for none.
+  * @return 1 if the thread exists or is the candidate, 0 otherwise.
+  */
+ static int ub_thread_active(int index, int candidate){
+   if (index == candidate){
+     return 1;
+   }
+   return TCB_ARRAY[index].state != NEW && TCB_ARRAY[index].state != DONE;
+ }
+
+ /**
+  * @brief Computes the IPCP blocking term B_i of a thread.
+  *
+  * Under IPCP a thread can be blocked at most once, by a single critical
+  * section of a lower priority thread on a mutex whose ceiling is at or
+  * above the thread's priority. B_i is the longest such declared section.
+  *
+  * @param[in] index Thread index (static priority) i.
+  * @param[in] candidate Index of the thread being admitted, -1 for none.
+  * @return B_i in ticks.
+  */
+ static uint32_t ub_blocking_term(int index, int candidate){
+   int max_threads = global_threads_info.max_threads;
+   uint32_t lower_threads = 0;
+   for (int lower = index + 1; lower < max_threads; lower++){
+     if (ub_thread_active(lower, candidate)){
+       lower_threads |= (1U << lower);
+     }
+   }
+
+   uint32_t blocking = rwlock_blocking_term(index, lower_threads);
+   for (uint32_t m = 0; m < global_threads_info.mutex_index; m++){
+     if ((int)mutex_array[m].prio_ceil > index){continue;} // Mutex can never block this thread
+     for (int lower = index + 1; lower < max_threads; lower++){
+       if (!(lower_threads & (1U << lower))){continue;}
+       if (mutex_array[m].cs_length[lower] > blocking){
+         blocking = mutex_array[m].cs_length[lower];
+       }
+     }
+   }
+   return blocking;
+ }
+
+ /* ub_test(prio, C, T)
+   1. Walks the threads from the highest priority down, including the new thread at index prio
+   2. Accumulates the utilization of each thread and the threads above it
+   3. Adds the thread's blocking term B_i/T_i and checks the sum against the ub bound for that many threads
    4. Returns the result
  */
  
  /**
-  * @brief Performs the utilization bound (UB) test for thread creation.
+  * @brief Performs the utilization bound (UB) test with IPCP blocking.
+  *
+  * For every thread i: sum(C_k/T_k, k <= i) + B_i/T_i <= U(i). Without any
+  * declared critical sections this is the plain UB test.
   *
+  * @param[in] prio Index of the new thread, -1 to check the current set only.
   * @param[in] C Computation time of the new thread.
   * @param[in] T Period of the new thread.
-  * @return 0 if the thread passes the UB test, -1 otherwise.
+  * @return 0 if the thread set passes the UB test, -1 otherwise.
   */
- int ub_test(int C, int T){
+ int ub_test(int prio, int C, int T){
     int max_threads = global_threads_info.max_threads;
-    float utilization = (float)C/T;
+    float utilization = 0;
     int compute, period = 0;
-    int count = 1;
+    int count = 0;
     for (int index = 0; index < max_threads; index ++){
-      if (TCB_ARRAY[index].state == NEW || TCB_ARRAY[index].state == DONE){continue;} // Uninitialized Thread Index in TCB Array
-      compute = TCB_ARRAY[index].computation_time;
-      period = TCB_ARRAY[index].period;
+      if (!ub_thread_active(index, prio)){continue;} // Uninitialized Thread Index in TCB Array
+      if (index == prio){
+        compute = C;
+        period = T;
+      }
+      else {
+        compute = TCB_ARRAY[index].computation_time;
+        period = TCB_ARRAY[index].period;
+      }
       utilization += (float)compute/period;
       count ++;
+      if (utilization + (float)ub_blocking_term(index, prio)/period > ub_table[count]){
+        return -1;
+      }
     }
-    if (utilization <= ub_table[count]){
-      return 0;
-    }
-    return -1;
+    return 0;
  }
  
  /* sysTickFlag:
@@ -321,7 +320,7 @@ Selected thread continues execution
    //run idle if there are still waiting threads
    for(uint32_t i = 0; i < max_threads; i++)
    {
-       if(TCB_ARRAY[i].state == WAITING || TCB_ARRAY[i].state == BLOCKED ) //|| TCB_ARRAY[i].state == BLOCKED
+       if(TCB_ARRAY[i].state == WAITING || TCB_ARRAY[i].state == BLOCKED || TCB_ARRAY[i].state == SUSPENDED)
        {
          //run idle thread
            return max_threads;
@@ -362,7 +361,16 @@ Selected thread continues execution
   
      TCB->msp = callee_saved_stk;
      TCB->svc_status = svc_stat; 
+
+     //charge the outgoing thread for exactly the cycles it ran
+     uint32_t now = dwt_get_cycles();
+     global_threads_info.thread_cycles[current_thread] += now - global_threads_info.switch_cycles;
+     global_threads_info.switch_cycles = now;
      int priority = thread_scheduler();
+     if ((uint32_t)priority != current_thread){
+       itm_switch(current_thread, priority);
+       sched_trace(SCHED_TRACE_SWITCH, priority, TCB_ARRAY[priority].priority, SCHED_TRACE_NO_MUTEX);
+     }
  
      global_threads_info.current_thread = priority;
      TCB_t * next_TCB = &TCB_ARRAY[priority];
@@ -440,6 +448,9 @@ Selected thread continues execution
     
       TCB_ARRAY[i].held_mutex_bitmap = 0;
       TCB_ARRAY[i].waiting_mutex_bitmap = 0;  
+      TCB_ARRAY[i].wait_status = 0;
+      TCB_ARRAY[i].wait_queue = NULL;
+      TCB_ARRAY[i].wait_period = 0;
      }
  
    //Initialize the idle thread
@@ -480,7 +491,8 @@ Selected thread continues execution
     TCB_ARRAY[prio_idle].state = READY;
     TCB_ARRAY[prio_idle].svc_status = 0; //clown moment
  
-    global_threads_info.thread_time[prio_idle] = 0;
+    global_threads_info.thread_cycles[prio_idle] = 0;
+    global_threads_info.release_cycles[prio_idle] = 0;
     //global_threads_info.thread_time_left_in_T[prio_idle] = 1;
     global_threads_info.thread_time_left_in_C[prio_idle] = 1;
  
@@ -492,7 +504,8 @@ Selected thread continues execution
     TCB_ARRAY[prio_default].state = RUNNING;
     TCB_ARRAY[prio_default].svc_status = 0; //clown moment
  
-    global_threads_info.thread_time[prio_default] = 0;
+    global_threads_info.thread_cycles[prio_default] = 0;
+    global_threads_info.release_cycles[prio_default] = 0;
     global_threads_info.thread_time_left_in_C[prio_default] = 1;
  
     for(uint32_t i = 0; i < max_threads; i++){
@@ -501,9 +514,19 @@ Selected thread continues execution
     }
  
    global_threads_info.current_thread = prio_default;
+   global_threads_info.switch_cycles = 0;
+   global_threads_info.cycles_per_tick = BASE_FREQ / 1000;
  
    // Initialize the mutex array
+   wait_queue_init(&sleepers);
    initialize_mutex_array();
+   initialize_sem_array();
+   initialize_event_array();
+   initialize_msgq_array();
+   initialize_rwlock_array();
+   initialize_barrier_array();
+   initialize_cond_array();
+   initialize_swtimer_array();
  
    return 0;
  }
@@ -535,7 +558,7 @@ Selected thread continues execution
       return -1;
     }
  
-    if(ub_test(C, T) < 0) {
+    if(ub_test(prio, C, T) < 0) {
       return -1;
     }
  
@@ -568,7 +591,8 @@ Selected thread continues execution
     TCB_ARRAY[prio].state = READY;
  
     /* Setting New Thread System Time Variables */
-    global_threads_info.thread_time[prio] = 0;
+    global_threads_info.thread_cycles[prio] = 0;
+    global_threads_info.release_cycles[prio] = 0;
     global_threads_info.thread_time_left_in_C[prio] = C;
    
  
@@ -586,6 +610,9 @@ Selected thread continues execution
   */
  int sys_scheduler_start( uint32_t frequency ){
    systick_init(frequency);
+   dwt_init();
+   global_threads_info.cycles_per_tick = BASE_FREQ / frequency;
+   global_threads_info.switch_cycles = dwt_get_cycles();
    pend_pendsv();
    return 0;
  }
@@ -616,14 +643,69 @@ Selected thread continues execution
  }
  
  /**
-  * @brief Gets the absolute time of the currently running thread.
+  * @brief Gets the 64-bit monotonic time in microseconds.
+  *
+  * @return Microseconds since the scheduler started.
+  */
+ uint64_t sys_get_time_us(){
+   return systick_get_time_us();
+ }
+
+ /**
+  * @brief Gets the CPU cycles a thread has run so far, including the part of
+  *        the current slice if it is the running thread. Must be called with
+  *        interrupts disabled or from SysTick/PendSV.
   *
-  * @return The absolute time of the currently running thread.
+  * @param[in] thread The thread.
+  * @return Cycles the thread ran.
+  */
+ static uint64_t thread_cycles_now( uint32_t thread ){
+   uint64_t cycles = global_threads_info.thread_cycles[thread];
+   if (thread == global_threads_info.current_thread)
+   {
+     cycles += dwt_get_cycles() - global_threads_info.switch_cycles;
+   }
+   return cycles;
+ }
+
+ /**
+  * @brief Gets the CPU cycles the currently running thread has run.
+  *
+  * @return Cycles, measured from context switch to context switch.
+  */
+ uint64_t sys_thread_time_cycles(){
+   int state = save_interrupt_state_and_disable();
+   uint64_t cycles = thread_cycles_now(global_threads_info.current_thread);
+   restore_interrupt_state(state);
+   return cycles;
+ }
+
+ /**
+  * @brief Gets the CPU time of the currently running thread in microseconds.
+  *
+  * @return Microseconds the thread ran.
+  */
+ uint64_t sys_thread_time_us(){
+   return sys_thread_time_cycles() / (BASE_FREQ / 1000000);
+ }
+
+ /**
+  * @brief Gets the CPU time of the currently running thread in ticks.
+  *
+  * @return Ticks the thread ran, rounded down.
   */
  uint32_t sys_thread_time(){
-   int thread = global_threads_info.current_thread;
-   int abs_thread_time = global_threads_info.thread_time[thread];
-   return abs_thread_time;
+   return (uint32_t)(sys_thread_time_cycles() / global_threads_info.cycles_per_tick);
+ }
+
+ /**
+  * @brief Starts a new period's budget for a thread. Called from SysTick.
+  *
+  * @param[in] thread The thread.
+  */
+ static void thread_release_budget( uint32_t thread ){
+   global_threads_info.thread_time_left_in_C[thread] = TCB_ARRAY[thread].computation_time;
+   global_threads_info.release_cycles[thread] = thread_cycles_now(thread);
  }
  
  /**
@@ -668,11 +750,66 @@ Selected thread continues execution
    pend_pendsv();
  }
  
+ /**
+  * @brief Deschedules the current thread until a given tick.
+  *
+  * The thread sleeps as a timed waiter, so it is neither scheduled nor
+  * charged until SysTick times it out at the tick, and lower priority
+  * threads or idle get the CPU meanwhile.
+  *
+  * @param[in] tick Absolute tick to wake up at.
+  * @return 0 once the tick is reached, -1 if the caller is the idle or
+  *         default thread, the wake status if the sleep was cut short.
+  */
+ int sys_sleep_until( uint32_t tick ) {
+   int state = save_interrupt_state_and_disable();
+
+   //wrap safe check for a tick that has already passed
+   int32_t ticks = (int32_t)(tick - sys_get_time());
+   if (ticks <= 0)
+   {
+     restore_interrupt_state(state);
+     return 0;
+   }
+
+   int err = wait_queue_enqueue(&sleepers, (uint32_t)ticks);
+   restore_interrupt_state(state);
+   if (err < 0)
+   {
+     return err;
+   }
+
+   //a sleep ends by timing out, anything else woke the thread early
+   int32_t status = wait_queue_sleep();
+   if (status == WAIT_TIMEOUT)
+   {
+     return 0;
+   }
+   return status;
+ }
+
+ /**
+  * @brief Deschedules the current thread for a number of ticks.
+  *
+  * @param[in] ticks Ticks to sleep.
+  * @return 0 on success, -1 if the caller is the idle or default thread.
+  */
+ int sys_sleep_for( uint32_t ticks ) {
+   return sys_sleep_until(sys_get_time() + ticks);
+ }
+
  void initialize_mutex_array(){
    for(uint32_t i = 0; i < MAX_MUTEXES; i++){
        mutex_array[i].locked_by = NOT_LOCKED;
        mutex_array[i].prio_ceil = 0;
        mutex_array[i].index = i;
+       mutex_array[i].locked_at = 0;
+       mutex_array[i].cs_overruns = 0;
+       for(uint32_t j = 0; j < 16; j++){
+         mutex_array[i].cs_length[j] = 0;
+       }
+       wait_queue_init(&mutex_array[i].waiters);
+       mutex_profile_init(&mutex_array[i].profile);
    }
  }
  /**
@@ -696,23 +833,244 @@ Selected thread continues execution
   
    return NULL;
  }
+
+ /**
+  * @brief Declares how long a thread holds a mutex at most.
+  *
+  * The declaration feeds the blocking term of the UB test, so the current
+  * thread set is re-checked and the declaration is rejected if it would make
+  * it unschedulable. Declarations for threads that are not created yet are
+  * checked when they are created.
+  *
+  * @param[in] mutex Pointer to the mutex.
+  * @param[in] prio Thread that locks the mutex.
+  * @param[in] cs_ticks Longest critical section of that thread on the mutex.
+  * @return 0 on success, -1 on invalid arguments or if the UB test fails.
+  */
+ int sys_mutex_declare( kmutex_t *mutex, uint32_t prio, uint32_t cs_ticks ) {
+   if (prio >= global_threads_info.max_threads || prio < mutex->prio_ceil){
+     printk("Warning: Thread %d can never lock mutex %d\n", prio, mutex->index);
+     return -1;
+   }
+
+   uint32_t old_length = mutex->cs_length[prio];
+   mutex->cs_length[prio] = cs_ticks;
+   if (ub_test(-1, 0, 0) < 0){
+     mutex->cs_length[prio] = old_length;
+     return -1;
+   }
+   return 0;
+ }
  
  /**
   * @brief Locks a mutex.
   *
   * This function locks the specified mutex, blocking if the mutex is already locked.
-  * checks if the calling thread has sufficient priority to acquire the mutex
+  * Under DEADLOCK_FAIL_LOCK, a lock that would deadlock kills the calling
+  * thread, since it returns nothing the caller could check.
   *
   * @param[in] mutex Pointer to the mutex to lock.
   */
  void sys_mutex_lock( kmutex_t *mutex ) {
+   int err = sys_mutex_lock_timed(mutex, WAIT_FOREVER);
+#if DEADLOCK_DETECTION && DEADLOCK_POLICY == DEADLOCK_FAIL_LOCK
+   //the caller has no way to see the failed lock, so it must not go on without it
+   if (err == MUTEX_DEADLOCK)
+   {
+     printk("Warning: Thread %d killed, locking mutex %d would deadlock\n",
+            global_threads_info.current_thread, mutex->index);
+     sys_thread_kill();
+   }
+#else
+   (void)err;
+#endif
+ }
+
+ /**
+  * @brief Gives a mutex to a thread and raises the thread to its ceiling.
+  *
+  * @param[in] mutex Pointer to the mutex.
+  * @param[in] thread Index of the new owner.
+  */
+ void mutex_take( kmutex_t *mutex, uint32_t thread ) {
+   mutex->locked_by = thread;
+   mutex->locked_at = sys_get_time();
+   mutex_profile_take(&mutex->profile);
+
+   //raise the thread's priority to the mutex's priority ceiling
+   if(TCB_ARRAY[thread].priority > mutex->prio_ceil)
+   {
+      TCB_ARRAY[thread].priority = mutex->prio_ceil;
+   }
+   sched_trace(SCHED_TRACE_LOCK, thread, TCB_ARRAY[thread].priority, mutex->index);
+
+   //set the bit corresponding to the mutex index in the held_mutex_bitmap
+   TCB_ARRAY[thread].held_mutex_bitmap = TCB_ARRAY[thread].held_mutex_bitmap | (1 << mutex->index);
+   //clear the bit corresponding to the mutex index in the waiting_mutex_bitmap
+   TCB_ARRAY[thread].waiting_mutex_bitmap = TCB_ARRAY[thread].waiting_mutex_bitmap & ~(1 << mutex->index);
+ }
+
+ /**
+  * @brief Releases a mutex, handing it to the highest priority waiter if
+  *        there is one. Must be called with interrupts disabled.
+  *
+  * @param[in] mutex Pointer to the mutex.
+  */
+ void mutex_give( kmutex_t *mutex ) {
+   mutex_profile_give(&mutex->profile, mutex->locked_by);
+
+   uint32_t waiters = mutex->waiters.waiters;
+   if (waiters != 0)
+   {
+     uint32_t next = __builtin_ctz(waiters);
+     mutex_take(mutex, next);
+     wait_queue_wake_thread(&mutex->waiters, next, WAIT_OK);
+   }
+   else
+   {
+     mutex->locked_by = NOT_LOCKED;
+   }
+ }
+
+#if DEADLOCK_DETECTION
+ /**
+  * @brief Follows the wait-for chain that starts at a mutex.
+  *
+  * Every thread waits for at most one mutex, so the wait-for graph seen from
+  * one edge is a simple chain: mutex -> owner -> mutex the owner waits for ->
+  * its owner ... If the chain comes back to the requesting thread, waiting
+  * would close a cycle. The walk is bounded by the number of threads, and a
+  * cycle that does not contain the requester was already reported when it
+  * was formed.
+  *
+  * @param[in] mutex Mutex the thread is about to wait for.
+  * @param[in] thread The requesting thread.
+  * @param[out] cycle_threads Owners along the cycle, ending with thread.
+  * @param[out] cycle_mutexes Mutexes along the cycle, starting with mutex.
+  * @return Length of the cycle, 0 if there is none.
+  */
+ static uint32_t mutex_find_cycle( kmutex_t *mutex, uint32_t thread, uint32_t *cycle_threads, uint32_t *cycle_mutexes ) {
+   kmutex_t *next = mutex;
+   for (uint32_t len = 0; len < global_threads_info.max_threads; len++)
+   {
+     uint32_t owner = next->locked_by;
+     if (owner == NOT_LOCKED || owner >= global_threads_info.max_threads)
+     {
+       return 0;
+     }
+     cycle_threads[len] = owner;
+     cycle_mutexes[len] = next->index;
+     if (owner == thread)
+     {
+       return len + 1;
+     }
+
+     uint32_t waiting = TCB_ARRAY[owner].waiting_mutex_bitmap;
+     if (waiting == 0)
+     {
+       return 0;
+     }
+     next = &mutex_array[__builtin_ctz(waiting)];
+   }
+   return 0;
+ }
+
+#if DEADLOCK_POLICY == DEADLOCK_KILL_LOWEST
+ /**
+  * @brief Kills a thread taking part in a deadlock and releases its mutexes.
+  *        Must be called with interrupts disabled.
+  *
+  * @param[in] thread The thread to kill.
+  */
+ static void mutex_kill_thread( uint32_t thread ) {
+   TCB_t *TCB = &TCB_ARRAY[thread];
+
+   if (TCB->state == SUSPENDED && TCB->wait_queue != NULL)
+   {
+     wait_queue_wake_thread(TCB->wait_queue, thread, MUTEX_DEADLOCK);
+   }
+   TCB->state = DONE;
+
+   for (uint32_t i = 0; i < MAX_MUTEXES; i++)
+   {
+     if (TCB->held_mutex_bitmap & (1 << i))
+     {
+       sched_trace(SCHED_TRACE_UNLOCK, thread, thread, i);
+       mutex_give(&mutex_array[i]);
+     }
+   }
+   TCB->held_mutex_bitmap = 0;
+   TCB->priority = thread;
+   pend_pendsv();
+ }
+#endif
+
+ /**
+  * @brief Picks the thread that gives up according to the deadlock policy.
+  *
+  * @param[in] thread The requesting thread.
+  * @param[in] cycle_threads Threads in the cycle.
+  * @param[in] cycle_len Length of the cycle.
+  * @return The requester under DEADLOCK_FAIL_LOCK, the lowest priority
+  *         (highest index) thread under DEADLOCK_KILL_LOWEST.
+  */
+ static uint32_t mutex_deadlock_victim( uint32_t thread, uint32_t *cycle_threads, uint32_t cycle_len ) {
+   uint32_t victim = thread;
+#if DEADLOCK_POLICY == DEADLOCK_KILL_LOWEST
+   for (uint32_t i = 0; i < cycle_len; i++)
+   {
+     if (cycle_threads[i] > victim)
+     {
+       victim = cycle_threads[i];
+     }
+   }
+#else
+   (void)cycle_threads;
+   (void)cycle_len;
+#endif
+   return victim;
+ }
+
+ /**
+  * @brief Prints a deadlock cycle. Called with interrupts enabled since
+  *        printk() may have to wait for the UART.
+  */
+ static void mutex_report_deadlock( uint32_t thread, uint32_t *cycle_threads, uint32_t *cycle_mutexes, uint32_t cycle_len, uint32_t victim ) {
+   printk("Deadlock: thread %d", thread);
+   for (uint32_t i = 0; i < cycle_len; i++)
+   {
+     printk(" -> mutex %d -> thread %d", cycle_mutexes[i], cycle_threads[i]);
+   }
+#if DEADLOCK_POLICY == DEADLOCK_KILL_LOWEST
+   printk(", killed thread %d\n", victim);
+#else
+   (void)victim;
+   printk(", lock failed\n");
+#endif
+ }
+#endif /* DEADLOCK_DETECTION */
+
+ /**
+  * @brief Locks a mutex, waiting at most timeout ticks for it.
+  *
+  * This function locks the specified mutex, sleeping on the mutex's wait queue
+  * if it is already locked. checks if the calling thread has sufficient priority
+  * to acquire the mutex. The unlocking thread hands the mutex over directly, so
+  * a thread woken with WAIT_OK already owns it.
+  *
+  * @param[in] mutex Pointer to the mutex to lock.
+  * @param[in] timeout Ticks to wait at most, 0 to try once, WAIT_FOREVER for no limit.
+  * @return 0 on success, WAIT_TIMEOUT if the mutex was not obtained in time,
+  *         MUTEX_DEADLOCK if waiting would deadlock, -1 on error.
+  */
+ int sys_mutex_lock_timed( kmutex_t *mutex, uint32_t timeout ) {
  
    uint32_t current_thread = global_threads_info.current_thread;
 
     if(current_thread == global_threads_info.max_threads)
    {
      
-     return;
+     return -1;
    }
 
     // Check if the current thread's priority is less than or equal to the mutex's priority ceiling
@@ -720,44 +1078,71 @@ Selected thread continues execution
      printk("Warning: Thread %d cannot lock mutex %d because (%d) high priority(%d)\n",
             current_thread, mutex->index, TCB_ARRAY[current_thread].priority, mutex->prio_ceil);
          sys_thread_kill();
-         return; 
+         return -1; 
  }
  
    // Check if the thread is trying to lock a mutex it already holds
    if (TCB_ARRAY[current_thread].held_mutex_bitmap & (1 << mutex->index)) {
      printk("Warning: Thread %d is trying to lock mutex %d again (double lock)\n", current_thread, mutex->index);
-     return;
+     return -1;
    }
  
-   //check if the the mutex is locked, if it is locked, we return to avoid blocking
+   int state = save_interrupt_state_and_disable();
+
+#if DEADLOCK_DETECTION
+   //refuse or break a wait that would close a cycle in the wait-for graph
+   uint32_t cycle_threads[16];
+   uint32_t cycle_mutexes[16];
+   uint32_t cycle_len = mutex_find_cycle(mutex, current_thread, cycle_threads, cycle_mutexes);
+   if (cycle_len != 0)
+   {
+     uint32_t victim = mutex_deadlock_victim(current_thread, cycle_threads, cycle_len);
+     restore_interrupt_state(state);
+     mutex_report_deadlock(current_thread, cycle_threads, cycle_mutexes, cycle_len, victim);
+#if DEADLOCK_POLICY == DEADLOCK_KILL_LOWEST
+     state = save_interrupt_state_and_disable();
+     if (TCB_ARRAY[victim].state != DONE)
+     {
+       mutex_kill_thread(victim);
+     }
+     if (victim == current_thread)
+     {
+       //PendSV switches away for good once interrupts are restored
+       restore_interrupt_state(state);
+       return MUTEX_DEADLOCK;
+     }
+#else
+     return MUTEX_DEADLOCK;
+#endif
+   }
+#endif
+
+   //if the mutex is locked, sleep until it is handed over or the timeout expires
    if(mutex->locked_by != NOT_LOCKED)
    {
-       TCB_ARRAY[current_thread].state = BLOCKED;
+       int err = wait_queue_enqueue(&mutex->waiters, timeout);
+       if (err < 0){
+         restore_interrupt_state(state);
+         return err;
+       }
 
        //Add the mutex to the waiting_mutex_bitmap
        TCB_ARRAY[current_thread].waiting_mutex_bitmap = TCB_ARRAY[current_thread].waiting_mutex_bitmap | (1 << mutex->index); 
-       //trigger context switch while waiting
-       
-       printk("Time:  Thread %d is blocked trying to lock %d\n",  current_thread, mutex->index);
-       pend_pendsv(); 
-       
-        while (mutex->locked_by != NOT_LOCKED){}
-        mutex->locked_by = current_thread;
+       sched_trace(SCHED_TRACE_BLOCK, current_thread, TCB_ARRAY[current_thread].priority, mutex->index);
+#if MUTEX_PROFILING
+       uint32_t wait_start = dwt_get_cycles();
+#endif
+       restore_interrupt_state(state);
 
-        //raise the thread's priority to the mutex's priority ceiling
-        if(TCB_ARRAY[current_thread].priority > mutex->prio_ceil)
-        {
-          TCB_ARRAY[current_thread].priority = mutex->prio_ceil;
-        }
-      
-        //set the bit corresponding to the mutex index in the held_mutex_bitmap
-        TCB_ARRAY[current_thread].held_mutex_bitmap = TCB_ARRAY[current_thread].held_mutex_bitmap | (1 << mutex->index); 
-        //clear the bit corresponding to the mutex index in the waiting_mutex_bitmap
-        TCB_ARRAY[current_thread].waiting_mutex_bitmap = TCB_ARRAY[current_thread].waiting_mutex_bitmap &  ~(1 << mutex->index); 
-            
-      return;
+       int32_t status = wait_queue_sleep();
+       if (status == WAIT_OK)
+       {
+         mutex_profile_wait(&mutex->profile, wait_start);
+       }
+       return status;
    }
 
+   uint32_t blocking_mutex = NOT_LOCKED;
    for (uint32_t i = 0; i < global_threads_info.max_mutexes; i++) {
     if ((mutex_array[i].locked_by != NOT_LOCKED) && (mutex_array[i].prio_ceil <= TCB_ARRAY[current_thread].priority)) {
 
@@ -766,30 +1151,52 @@ Selected thread continues execution
         // If the mutex is already locked by another thread with a higher priority ceiling, block the current thread
         // In otherwords its a check about scheduler working properly
         // Its getting hung with the fact that this thread is calling lock on mutex with ceiling 1 and then 0
-      
-        printk("Warning: Thread %d cannot lock mutex %d because another thread holds a mutex with a higher prio ceiling: %d.\n",
-               current_thread, mutex->index, i);
-        return;
+        blocking_mutex = i;
+        break;
     }
   }
-   
+
+   if (blocking_mutex != NOT_LOCKED) {
+     restore_interrupt_state(state);
+     printk("Warning: Thread %d cannot lock mutex %d because another thread holds a mutex with a higher prio ceiling: %d.\n",
+            current_thread, mutex->index, blocking_mutex);
+     return -1;
+   }
  
    //lock the mutex 
-   mutex->locked_by = current_thread;
-
-   //raise the thread's priority to the mutex's priority ceiling
-   if(TCB_ARRAY[current_thread].priority > mutex->prio_ceil)
+   mutex_take(mutex, current_thread);
+   restore_interrupt_state(state);
+   return 0;
+ }
+ 
+ /**
+  * @brief Recomputes the dynamic priority of a thread from the locks it
+  *        still holds.
+  *
+  * @param[in] thread The thread.
+  */
+ void thread_update_priority( uint32_t thread ) {
+   //the index of the thread is equal to its static priority
+   uint32_t new_priority = thread;
+   for (uint32_t i = 0; i < MAX_MUTEXES; i++)
    {
-      TCB_ARRAY[current_thread].priority = mutex->prio_ceil;
+     //check if the thread is holding any other mutexes
+     //if the priority ceiling of the held mutex is higher, set new priority to that
+     
+     if(TCB_ARRAY[thread].held_mutex_bitmap & (1 << i))
+     {
+       if(mutex_array[i].prio_ceil < new_priority)
+       {
+         new_priority = mutex_array[i].prio_ceil;
+       }
+     }
    }
+   new_priority = rwlock_held_ceiling(thread, new_priority);
  
-   //set the bit corresponding to the mutex index in the held_mutex_bitmap
-   TCB_ARRAY[current_thread].held_mutex_bitmap = TCB_ARRAY[current_thread].held_mutex_bitmap | (1 << mutex->index); 
-   //clear the bit corresponding to the mutex index in the waiting_mutex_bitmap
-   TCB_ARRAY[current_thread].waiting_mutex_bitmap = TCB_ARRAY[current_thread].waiting_mutex_bitmap &  ~(1 << mutex->index); 
-
+   //update the dynamic priority of the thread
+   TCB_ARRAY[thread].priority = new_priority;
  }
- 
+
  /**
   * @brief Unlocks a mutex.
   *
@@ -821,48 +1228,59 @@ Selected thread continues execution
      return;
    }
  
-   //unlock the mutex
-   mutex->locked_by = NOT_LOCKED;
+   //check the hold time against the declared critical section length
+   uint32_t held = sys_get_time() - mutex->locked_at;
+   if (mutex->cs_length[current_thread] != 0 && held > mutex->cs_length[current_thread]) {
+     mutex->cs_overruns++;
+     printk("Warning: Thread %d held mutex %d for %d ticks, declared %d\n",
+            current_thread, mutex->index, held, mutex->cs_length[current_thread]);
+   }
+
+   //unlock the mutex, handing it to the highest priority waiter if there is one
+   int state = save_interrupt_state_and_disable();
+   mutex_give(mutex);
 
    //clear the bit corresponding to the mutex index in the held_mutex_bitmap
    TCB_ARRAY[current_thread].held_mutex_bitmap = TCB_ARRAY[current_thread].held_mutex_bitmap & ~(1 << mutex->index); 
  
    //restore the thread's priority to its original value
-   //the index of the current thread in equal to its static priority
-   uint32_t new_priority = current_thread;
-   for (uint32_t i = 0; i < MAX_MUTEXES; i++)
-   {
-     //check if the thread is holding any other mutexes
-     //if the priority ceiling of the held mutex is higher, set new priority to that
-     
-     if(TCB_ARRAY[current_thread].held_mutex_bitmap & (1 << i))
-     {
-       if(mutex_array[i].prio_ceil < new_priority)
-       {
-         new_priority = mutex_array[i].prio_ceil;
-       }
-     }
-   }
- 
-   //update the dynamic priority of the thread
-   TCB_ARRAY[current_thread].priority = new_priority;
+   thread_update_priority(current_thread);
+   sched_trace(SCHED_TRACE_UNLOCK, current_thread, TCB_ARRAY[current_thread].priority, mutex->index);
+   restore_interrupt_state(state);
 
-   //If there are any threads waiting for the mutex, wake them up
-   for(uint32_t i = 0; i < global_threads_info.max_threads; i++)
+  pend_pendsv();
+ }
+
+ /**
+  * @brief Prints the contention and hold time counters of every mutex.
+  *
+  * Averages are computed here so the lock path only does additions.
+  *
+  * @return 0 on success, -1 if profiling is compiled out.
+  */
+ int sys_mutex_profile_dump() {
+#if MUTEX_PROFILING
+   printk("mutex acq contended hold_avg hold_max holder wait_avg wait_max (cycles)\n");
+   for (uint32_t i = 0; i < global_threads_info.mutex_index; i++)
    {
+     //copy with interrupts disabled so the counters are consistent
+     int state = save_interrupt_state_and_disable();
+     mutex_profile_t p = mutex_array[i].profile;
+     restore_interrupt_state(state);
 
-       if(TCB_ARRAY[i].state == BLOCKED )
-     {
-       //update the waiting_mutex_bitmap for waiting threads
-        TCB_ARRAY[i].waiting_mutex_bitmap = TCB_ARRAY[i].waiting_mutex_bitmap & ~(1 << mutex->index);
-      
-       
-    }
-  }
-  pend_pendsv();
+     uint32_t hold_avg = p.acquisitions ? (uint32_t)(p.hold_total / p.acquisitions) : 0;
+     uint32_t wait_avg = p.contended ? (uint32_t)(p.wait_total / p.contended) : 0;
+     printk("%u %u %u %u %u %u %u %u\n", i, p.acquisitions, p.contended,
+            hold_avg, p.hold_max, p.longest_holder, wait_avg, p.wait_max);
+   }
+   return 0;
+#else
+   return -1;
+#endif
  }
 
 extern uint32_t total_count;
+extern uint32_t total_count_hi;
 
  /**
  * @brief SysTick interrupt handler.
@@ -873,14 +1291,27 @@ extern uint32_t total_count;
 
 
 void systick_c_handler() {
+  itm_isr_enter();
   
   total_count = total_count + 1;
+  if (total_count == 0){
+    total_count_hi = total_count_hi + 1;
+  }
+  wait_queue_tick(total_count);
+  swtimer_tick(total_count);
+  uart_tx_poll();
 
   int curr_running = global_threads_info.current_thread;  
   int max_threads = global_threads_info.max_threads;
-  global_threads_info.thread_time[curr_running] += 1;
   if (curr_running != max_threads && curr_running != max_threads + 1){
-    int time_left_in_compute = global_threads_info.thread_time_left_in_C[curr_running] - 1;
+    // Budget is charged in cycles, so a thread that blocked mid tick only pays for what it ran
+    uint32_t cycles_per_tick = global_threads_info.cycles_per_tick;
+    uint64_t used = thread_cycles_now(curr_running) - global_threads_info.release_cycles[curr_running];
+    uint64_t budget = (uint64_t)TCB_ARRAY[curr_running].computation_time * cycles_per_tick;
+    uint32_t time_left_in_compute = 0;
+    if (used < budget){
+      time_left_in_compute = (uint32_t)((budget - used + cycles_per_tick - 1) / cycles_per_tick);
+    }
     
     if (time_left_in_compute == 0){
       // Thread finished its computation time
@@ -888,8 +1319,11 @@ void systick_c_handler() {
        printk("Warning: Thread %d is holding a mutex and has finished computation time. \n", curr_running);
    }
 
-   time_left_in_compute = TCB_ARRAY[curr_running].computation_time;
-   TCB_ARRAY[curr_running].state = WAITING;
+   // A thread that just enqueued itself on a wait queue stays SUSPENDED until it is woken
+   if (TCB_ARRAY[curr_running].state == RUNNING || TCB_ARRAY[curr_running].state == READY){
+     TCB_ARRAY[curr_running].state = WAITING;
+   }
+   sched_trace(SCHED_TRACE_BUDGET, curr_running, TCB_ARRAY[curr_running].priority, SCHED_TRACE_NO_MUTEX);
       
     }
     global_threads_info.thread_time_left_in_C[curr_running] = time_left_in_compute;
@@ -901,11 +1335,20 @@ void systick_c_handler() {
       
       if (sys_get_time() % TCB_ARRAY[i].period == 0){
        // Thread's new period starts - release the thread
-          global_threads_info.thread_time_left_in_C[i] = TCB_ARRAY[i].computation_time;   
+          thread_release_budget(i);
          TCB_ARRAY[i].state = READY;
+         sched_trace(SCHED_TRACE_RELEASE, i, TCB_ARRAY[i].priority, SCHED_TRACE_NO_MUTEX);
       }
       
     }
+    else if (TCB_ARRAY[i].state == SUSPENDED && TCB_ARRAY[i].wait_period){
+      // Rendezvous waiter reached its period, it now only waits for the other side
+      if (sys_get_time() % TCB_ARRAY[i].period == 0){
+        thread_release_budget(i);
+        TCB_ARRAY[i].wait_period = 0;
+      }
+    }
   }
   pend_pendsv();
+  itm_isr_exit();
 }
\ No newline at end of file
@@ -65,12 +65,28 @@ struct sysclock_map{
  */
 #define STK_CLKSOURCE (1<<2)
 
+/**
+ * @brief Interrupt control and state register.
+ */
+#define ICSR ((volatile uint32_t *)0xE000ED04)
+
+/**
+ * @brief Set while a SysTick exception is pending.
+ */
+#define ICSR_PENDSTSET (1 << 26)
+
 
 /**
  * @brief Total number of ticks since the SysTick timer was initialized.
  */
 volatile uint32_t total_count;
 
+/**
+ * @brief Number of times total_count wrapped, the upper half of the 64-bit
+ *        tick count.
+ */
+volatile uint32_t total_count_hi;
+
 /**
  * @brief Initializes the SysTick timer.
  *
@@ -90,6 +106,7 @@ void systick_init(UNUSED uint32_t frequency) {
     sys -> STK_CTRL = sys -> STK_CTRL | STK_CLKSOURCE;
 
     total_count = 0;
+    total_count_hi = 0;
 }
 
 /**
@@ -114,6 +131,48 @@ uint32_t systick_get_ticks() {
     return total_count;
 }
 
+/**
+ * @brief Reads the 64-bit processor cycle count since the SysTick timer was
+ *        initialized.
+ *
+ * The tick count is re-read until it did not change under us, so SysTick
+ * may preempt the read at any point. With SysTick masked (in an ISR, or with
+ * interrupts disabled) the counter may already have reloaded without the
+ * tick being counted; the pending bit tells, and STK_VAL is then read again
+ * so it is known to be from after the reload.
+ *
+ * @return Cycles since systick_init(), monotonic.
+ */
+uint64_t systick_get_cycles() {
+    struct sysclock_map * sys = STK_BASE;
+    uint32_t hi, lo, val, pending;
+
+    do {
+        hi = total_count_hi;
+        lo = total_count;
+        val = sys -> STK_VAL;
+        pending = *ICSR & ICSR_PENDSTSET;
+    } while (hi != total_count_hi || lo != total_count);
+
+    uint64_t ticks = ((uint64_t)hi << 32) | lo;
+    if (pending) {
+        val = sys -> STK_VAL;
+        ticks++;
+    }
+
+    uint32_t reload = sys -> STK_LOAD;
+    return ticks * (reload + 1) + (reload - val);
+}
+
+/**
+ * @brief Reads the monotonic time in microseconds.
+ *
+ * @return Microseconds since systick_init().
+ */
+uint64_t systick_get_time_us() {
+    return systick_get_cycles() / (BASE_FREQ / 1000000);
+}
+
 /**
  * @brief Flag indicating whether a SysTick interrupt has occurred.
  */
@@ -1,7 +1,17 @@
 /**
  * @file uart.c
  *
- * @brief Interrupt-driven UART implementation. Similar to a stream buffer.
+ * @brief Interrupt-driven UART implementation over lock-free ring buffers.
+ *        Transmission is done by DMA1 Stream6 straight out of the transmit
+ *        rings (see UART_TX_DMA in kernel_config.h), so the CPU only touches
+ *        each byte once, when it is queued. There is one transmit ring per
+ *        priority band (UART_TX_BANDS) and the highest band with data is
+ *        always sent first, so a low priority logger cannot make a high
+ *        priority writer wait behind its output. Deferred log records
+ *        (deflog.h) go out whenever no text is queued. Reception is done by DMA1
+ *        Stream5 into a circular receive ring (UART_RX_DMA) that readers
+ *        consume in place. The DMA position is published at the end of
+ *        every frame (IDLE line) and every half buffer.
  *
  * @date March 22, 2025
  *
@@ -13,6 +23,14 @@
 #include <nvic.h>
 #include <gpio.h>
 #include <arm.h>
+#include <ring_buffer.h>
+#include <dma.h>
+#include <systick.h>
+#include <wait_queue.h>
+#include <syscall_thread.h>
+#include <klog.h>
+#include <itm.h>
+#include <kernel_config.h>
 
 /** @brief The UART register map. */
 struct uart_reg_map {
@@ -40,8 +58,20 @@ struct uart_reg_map {
 /** @brief Enable Bit for UART Receive */
 #define RX_EN (1 << 2)
 
-/** @brief Transmit Speed Setting Val*/
-#define USARTDIV (0x8 << 4 | 0xB)
+/** @brief Oversampling by 8 instead of 16, doubles the fastest baud rate */
+#define CR1_OVER8 (1 << 15)
+
+/** @brief Transmission Complete Bit in UART Status Register */
+#define SR_TRANSMITCOMPLETE (1 << 6)
+
+/** @brief APB1 prescaler field in RCC CFGR */
+//@{
+#define RCC_CFGR_PPRE1_SHIFT 10
+#define RCC_CFGR_PPRE1_MASK 0x7
+//@}
+
+/** @brief Largest baud rate error accepted, in tenths of a percent */
+#define UART_MAX_BAUD_ERROR 25
 
 /** @brief Transmit Ready Bit in UART Status Register */
 #define SR_TRANSMITREADY (1 << 7)
@@ -49,6 +79,14 @@ struct uart_reg_map {
 /** @brief Receive Ready Bit in UART Status Register */
 #define SR_RECEIVEREADY (1 << 5)
 
+/** @brief Idle Line Detected Bit in UART Status Register */
+#define SR_IDLE (1 << 4)
+
+/**
+ * @brief Enable Idle Line Interrupt.
+ */
+#define CR1_IDLEIE (1 << 4)
+
 /**
  * @brief Enable Transmit Data Register Empty Interrupt.
  */
@@ -59,88 +97,306 @@ struct uart_reg_map {
  */
 #define CR1_RXNEIE (1 << 5)
 
+/**
+ * @brief Enable DMA requests for transmission.
+ */
+#define CR3_DMAT (1 << 7)
+
+/**
+ * @brief Enable DMA requests for reception.
+ */
+#define CR3_DMAR (1 << 6)
+
+/** @brief DMA1 stream and channel wired to USART2_TX */
+//@{
+#define UART_TX_DMA_STREAM 6
+#define UART_TX_DMA_CHANNEL 4
+#define UART_TX_DMA_IRQ 17
+//@}
+
+/** @brief DMA1 stream and channel wired to USART2_RX */
+//@{
+#define UART_RX_DMA_STREAM 5
+#define UART_RX_DMA_CHANNEL 4
+#define UART_RX_DMA_IRQ 16
+//@}
+
 /**
  * @brief Attribute to mark unused function parameters.
  */
 #define UNUSED __attribute__((unused))
 
 /**
- * @brief Size of the circular buffer for UART transmission and reception.
+ * @brief Size of the ring buffers for UART transmission and reception, must
+ *        be a power of two.
  */
 #define size_of_Queue (16)
 
 /**
- * @struct Queue
- * @brief Circular buffer for UART data transmission and reception.
+ * @brief Size of each transmit ring, must be a power of two. Together the
+ *        rings are large enough that a burst of logging does not make
+ *        writers wait.
  */
-typedef struct Queue{
-  char array[size_of_Queue]; /**< Array to hold the buffer data. */
-  uint32_t tail;            /**< Index for the tail of the buffer. */
-  uint32_t header;          /**< Index for the header of the buffer. */
-  uint32_t count;           /**< Number of elements in the buffer. */
-}Queue;
+#define size_of_TxQueue (1024 / UART_TX_BANDS)
 
 /**
- * @brief Circular buffer for UART transmission.
+ * @brief Most bytes sent from a band below the top one before the bands
+ *        are looked at again. Bounds how long a higher priority writer
+ *        waits behind lower priority output, 64 bytes is 5.6 ms at 115200
+ *        baud.
  */
-Queue TransmitBuffer;
+#define UART_TX_CHUNK 64
 
 /**
- * @brief Circular buffer for UART reception.
+ * @brief Value of tx_dma_band while the DMA stream sends log records.
  */
-Queue ReceiveBuffer;
+#define UART_TX_LOG UART_TX_BANDS
 
 /**
- * @brief Initializes the UART circular buffers.
- *
- * This function initializes the `TransmitBuffer` and `ReceiveBuffer` by setting
- * their tail, header, and count to 0.
+ * @brief Storage for the transmit rings.
  */
-void initBuffer(){
-  TransmitBuffer.tail = 0;
-  TransmitBuffer.header = 0;
-  TransmitBuffer.count = 0;
+static uint8_t transmit_data[UART_TX_BANDS][size_of_TxQueue];
+
+#if UART_TX_DMA
+/**
+ * @brief Bytes of the ring the DMA stream is sending, 0 while it is idle.
+ */
+static volatile uint32_t tx_dma_len;
+
+/**
+ * @brief Band whose ring the DMA stream is sending.
+ */
+static volatile uint32_t tx_dma_band;
+
+/**
+ * @brief Bytes of the current DMA transfer already given back to the ring.
+ */
+static volatile uint32_t tx_dma_released;
+#endif
+
+#if UART_RX_DMA
+/**
+ * @brief Size of the receive ring, must be a power of two. Half of it has
+ *        to cover the longest time a reader may not run: 256 bytes is
+ *        2.8 ms at 921600 baud.
+ */
+#define size_of_RxQueue (512)
+#else
+#define size_of_RxQueue size_of_Queue
+#endif
+
+/**
+ * @brief Storage for the receive ring, written in place by the DMA stream.
+ */
+static uint8_t receive_data[size_of_RxQueue];
+
+/**
+ * @brief Ring buffers for UART transmission, one per priority band.
+ *        Written by threads, SVCs and kernel handlers (MPSC), drained by
+ *        the DMA or USART2 interrupt.
+ */
+ring_buffer_t TransmitBuffer[UART_TX_BANDS];
+
+/**
+ * @brief Ring buffer for UART reception. Filled by DMA or the USART2
+ *        interrupt, drained by sys_read() (SPSC).
+ */
+ring_buffer_t ReceiveBuffer;
+
+/**
+ * @brief Free space in the transmit ring at which blocked writers are
+ *        woken. Waking them for every byte would only make them sleep again.
+ */
+#define TX_WAKE_SPACE (size_of_TxQueue / 2)
 
-  ReceiveBuffer.tail = 0;
-  ReceiveBuffer.header = 0;
-  ReceiveBuffer.count = 0;
+/**
+ * @brief Threads sleeping until the receive ring has data.
+ */
+static wait_queue_t uart_rx_waiters;
+
+/**
+ * @brief Threads sleeping until the transmit ring of their band has space.
+ */
+static wait_queue_t uart_tx_waiters[UART_TX_BANDS];
+
+/**
+ * @brief Number of received bytes dropped (or overwritten by the DMA)
+ *        because ReceiveBuffer was full.
+ */
+volatile uint32_t uart_rx_overruns;
+
+static void uart_tx_start();
+
+/**
+ * @brief Initializes the UART ring buffers.
+ */
+void initBuffer(){
+  for (uint32_t band = 0; band < UART_TX_BANDS; band++){
+    ring_init(&TransmitBuffer[band], transmit_data[band], size_of_TxQueue);
+    wait_queue_init(&uart_tx_waiters[band]);
+  }
+  ring_init(&ReceiveBuffer, receive_data, size_of_RxQueue);
+  uart_rx_overruns = 0;
+  wait_queue_init(&uart_rx_waiters);
+  klog_init();
 };
 
 /**
- * @brief State variable to save and restore interrupt state.
+ * @brief Picks the transmit band of the caller from the priority of the
+ *        current thread, spreading the threads evenly over the bands. The
+ *        idle and default threads use the lowest band.
+ *
+ * @return The band, 0 is the highest.
  */
-int state;
+static uint32_t uart_tx_band(){
+  uint32_t thread = global_threads_info.current_thread;
+  uint32_t max_threads = global_threads_info.max_threads;
+
+  if (thread >= max_threads){
+    return UART_TX_BANDS - 1;
+  }
+  return thread * UART_TX_BANDS / max_threads;
+}
 
 /**
- * @brief Adds a character to the specified circular buffer.
+ * @brief Finds the highest priority band with queued bytes.
  *
- * @param[in] c The character to enqueue.
- * @param[in] buffer Pointer to the circular buffer.
+ * @return The band, -1 if all rings are empty.
  */
-void enqueue(char c, Queue * buffer){
-  if (buffer -> count >= size_of_Queue){
-    
-    return;
+static int uart_tx_next_band(){
+  for (int band = 0; band < UART_TX_BANDS; band++){
+    if (ring_count(&TransmitBuffer[band]) != 0){
+      return band;
+    }
   }
-  buffer->count = buffer-> count + 1;
-  buffer->array[buffer ->header] = c;
-  buffer -> header = (buffer -> header + 1) % size_of_Queue;
-  
-  return;
+  return -1;
 }
 
 /**
- * @brief Removes a character from the specified circular buffer.
+ * @brief Counts the text bytes queued in all bands.
  *
- * @param[in] buffer Pointer to the circular buffer.
- * @return The character dequeued from the buffer.
+ * @return Number of bytes not handed to the UART yet.
  */
-char dequeue(Queue * buffer){
-  char c;
-  buffer -> count = buffer ->count - 1;
-  c = buffer -> array[buffer ->tail];
-  buffer -> tail = (buffer -> tail + 1) % size_of_Queue;
-  return c;
+static uint32_t uart_tx_pending(){
+  uint32_t pending = 0;
+  for (uint32_t band = 0; band < UART_TX_BANDS; band++){
+    pending += ring_count(&TransmitBuffer[band]);
+  }
+  return pending;
+}
+
+/**
+ * @brief Wakes the readers once received bytes were published.
+ */
+static void uart_wake_readers(){
+  if (uart_rx_waiters.waiters != 0){
+    wait_queue_wake_all(&uart_rx_waiters, WAIT_OK);
+  }
+}
+
+/**
+ * @brief Wakes the writers of a band once enough of its ring is free.
+ *
+ * @param[in] band The band that was drained.
+ */
+static void uart_wake_writers(uint32_t band){
+  if (uart_tx_waiters[band].waiters != 0 && ring_free(&TransmitBuffer[band]) >= TX_WAKE_SPACE){
+    wait_queue_wake_all(&uart_tx_waiters[band], WAIT_OK);
+  }
+}
+
+/**
+ * @brief Computes the USART2 kernel clock, the system clock (16MHz HSI)
+ *        divided by the APB1 prescaler.
+ *
+ * @return PCLK1 in Hz.
+ */
+static uint32_t uart_pclk1(){
+  struct rcc_reg_map *rcc = RCC_BASE;
+  uint32_t ppre1 = (rcc -> cfgr >> RCC_CFGR_PPRE1_SHIFT) & RCC_CFGR_PPRE1_MASK;
+
+  /* 0xx is not divided, 100 to 111 divide by 2 to 16 */
+  if (ppre1 < 4){
+    return BASE_FREQ;
+  }
+  return BASE_FREQ / (2 << (ppre1 - 4));
+}
+
+/**
+ * @brief Computes BRR and the oversampling mode for a baud rate.
+ *
+ * BRR holds USARTDIV in fixed point with 4 (OVER16) or 3 (OVER8) fraction
+ * bits, so in both modes the value to program is pclk / baud rounded,
+ * with the OVER8 fraction moved down one bit. OVER16 samples better and
+ * is used whenever the rate allows it.
+ *
+ * @param[in] baud The baud rate.
+ * @param[out] brr Value for BRR.
+ * @param[out] over8 CR1_OVER8 or 0.
+ * @return 0 on success, -1 if the rate cannot be reached closely enough.
+ */
+static int uart_compute_brr(uint32_t baud, uint32_t *brr, uint32_t *over8){
+  uint32_t pclk = uart_pclk1();
+  if (baud == 0){
+    return -1;
+  }
+
+  uint32_t div = (pclk + baud / 2) / baud;
+  if (div >= 16){
+    *over8 = 0;
+    *brr = div;
+  }
+  else if (div >= 8){
+    *over8 = CR1_OVER8;
+    *brr = ((div >> 3) << 4) | (div & 0x7);
+  }
+  else {
+    return -1;
+  }
+  if (*brr > 0xFFFF){
+    return -1;
+  }
+
+  /* Error of the rate we actually get, in tenths of a percent */
+  uint32_t actual = pclk / div;
+  uint32_t diff = actual > baud ? actual - baud : baud - actual;
+  if ((uint64_t)diff * 1000 > (uint64_t)baud * UART_MAX_BAUD_ERROR){
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Changes the baud rate.
+ *
+ * Queued output is sent at the old rate first. Input that arrives during
+ * the switch may be garbled.
+ *
+ * @param[in] baud The baud rate, up to PCLK1 / 8.
+ * @return 0 on success, -1 if the rate is not reachable from PCLK1.
+ */
+int uart_set_baud_rate(uint32_t baud){
+  struct uart_reg_map *uart = UART2_BASE;
+  uint32_t brr, over8;
+
+  if (uart_compute_brr(baud, &brr, &over8) < 0){
+    return -1;
+  }
+
+  /* Let the rings and the shift register drain, UE must be off to change OVER8 */
+  if (uart -> CR1 & UART_EN){
+    uart_tx_start();
+    while (uart_tx_pending() > 0 || deflog_pending()){
+    }
+    while (!(uart -> SR & SR_TRANSMITCOMPLETE)){
+    }
+  }
+
+  uart -> CR1 &= ~UART_EN;
+  uart -> CR1 = (uart -> CR1 & ~CR1_OVER8) | over8;
+  uart -> BRR = (uart -> BRR & 0xFFFF0000) | brr;
+  uart -> CR1 |= UART_EN;
+  return 0;
 }
 
 /**
@@ -149,28 +405,55 @@ char dequeue(Queue * buffer){
  * Configures the UART2 peripheral for transmission and reception, sets up the
  * baud rate, and initializes the GPIO pins for TX and RX.
  *
- * @param[in] baud The baud rate (currently unused, hardcoded in the implementation).
+ * @param[in] baud The baud rate, 0 for UART_DEFAULT_BAUD.
  */
 void uart_init(int baud){
-  (void) baud; /* Here to suppress the Unused Variable Error. Baud is hardcoded*/
-                
   struct rcc_reg_map *rcc = RCC_BASE;
   rcc -> apb1_enr |= UARTCLOCK_EN;
 
   struct uart_reg_map *uart = UART2_BASE;
 
-  uart -> CR1 |= TX_EN | RX_EN | CR1_RXNEIE;
-  uart -> CR1 |= UART_EN;
-
-  /* Note: UARTDIV is 8.681 */
-  uart -> BRR = (uart -> BRR & 0xFFFF0000) | USARTDIV;
+  uart -> CR1 |= TX_EN | RX_EN;
 
   initBuffer();
 
+  if (baud <= 0 || uart_set_baud_rate(baud) < 0){
+    uart_set_baud_rate(UART_DEFAULT_BAUD);
+  }
+
+#if UART_TX_DMA
+  rcc -> ahb1_enr |= DMA1_CLOCK_EN;
+  struct dma_stream_map *stream = &(DMA1_BASE) -> S[UART_TX_DMA_STREAM];
+  stream -> CR = 0;
+  stream -> PAR = (uint32_t)&uart -> DR;
+  stream -> CR = DMA_SxCR_CHSEL(UART_TX_DMA_CHANNEL) | DMA_SxCR_MINC | DMA_SxCR_M2P
+               | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+  uart -> CR3 |= CR3_DMAT;
+  tx_dma_len = 0;
+  nvic_irq(UART_TX_DMA_IRQ, IRQ_ENABLE);
+#endif
+
+#if UART_RX_DMA
+  rcc -> ahb1_enr |= DMA1_CLOCK_EN;
+  struct dma_stream_map *rx_stream = &(DMA1_BASE) -> S[UART_RX_DMA_STREAM];
+  rx_stream -> CR = 0;
+  rx_stream -> PAR = (uint32_t)&uart -> DR;
+  rx_stream -> M0AR = (uint32_t)receive_data;
+  rx_stream -> NDTR = size_of_RxQueue;
+  rx_stream -> CR = DMA_SxCR_CHSEL(UART_RX_DMA_CHANNEL) | DMA_SxCR_MINC | DMA_SxCR_P2M
+                  | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+  rx_stream -> CR |= DMA_SxCR_EN;
+  uart -> CR3 |= CR3_DMAR;
+  uart -> CR1 |= CR1_IDLEIE;
+  nvic_irq(UART_RX_DMA_IRQ, IRQ_ENABLE);
+#else
+  uart -> CR1 |= CR1_RXNEIE;
+#endif
+
   nvic_irq(38, IRQ_ENABLE);
 
   /* Initializing Port A Pin 2 and Pin 3 which act as TX and RX Respectively*/
-  gpio_init(GPIO_A, 2 , MODE_ALT, OUTPUT_PUSH_PULL, OUTPUT_SPEED_LOW, PUPD_NONE, ALT7);
+  gpio_init(GPIO_A, 2 , MODE_ALT, OUTPUT_PUSH_PULL, OUTPUT_SPEED_HIGH, PUPD_NONE, ALT7);
   gpio_init(GPIO_A, 3, MODE_ALT, OUTPUT_OPEN_DRAIN, OUTPUT_SPEED_LOW, PUPD_NONE, ALT7);
 
 
@@ -178,94 +461,382 @@ void uart_init(int baud){
 
 }
 
+#if UART_TX_DMA
+/**
+ * @brief Starts the DMA stream on the next contiguous chunk of the highest
+ *        band with data if it is idle, or on log records if no text is
+ *        queued. Called by producers after queueing and by the DMA
+ *        interrupt when a transfer completes.
+ *
+ * Chunks of the lower bands and of log records are cut at UART_TX_CHUNK,
+ * so newly queued higher priority output goes out after at most that many
+ * bytes. A text chunk is cut after its last newline if it has one, so
+ * another band only lands inside lines longer than a chunk.
+ */
+static void uart_tx_kick(){
+  int state = save_interrupt_state_and_disable();
+
+  if (tx_dma_len == 0){
+    const uint8_t *data = NULL;
+    uint32_t n = 0;
+    int band = deflog_in_record() ? -1 : uart_tx_next_band();
+
+    if (band >= 0){
+      ring_buffer_t *rb = &TransmitBuffer[band];
+      uint32_t offset;
+      n = ring_peek_contiguous(rb, &offset);
+      if (band != 0 && n > UART_TX_CHUNK){
+        n = UART_TX_CHUNK;
+        uint32_t line = n;
+        while (line != 0 && rb -> data[offset + line - 1] != '\n'){
+          line--;
+        }
+        if (line != 0){
+          n = line;
+        }
+      }
+      data = &rb -> data[offset];
+    }
+    else {
+      band = UART_TX_LOG;
+      n = deflog_peek(&data, UART_TX_CHUNK);
+    }
+
+    if (n != 0){
+      struct dma_reg_map *dma = DMA1_BASE;
+      struct dma_stream_map *stream = &dma -> S[UART_TX_DMA_STREAM];
+
+      tx_dma_band = band;
+      tx_dma_len = n;
+      tx_dma_released = 0;
+      dma -> HIFCR = DMA_ALL_FLAGS << DMA_FLAG_SHIFT(UART_TX_DMA_STREAM);
+      stream -> M0AR = (uint32_t)data;
+      stream -> NDTR = n;
+      stream -> CR |= DMA_SxCR_EN;
+    }
+  }
+
+  restore_interrupt_state(state);
+}
+#endif
+
+/**
+ * @brief Starts transmission of whatever was queued.
+ */
+static void uart_tx_start(){
+#if UART_TX_DMA
+  uart_tx_kick();
+#else
+  /* If the ISR drained the byte before this, we only get one spurious TXE */
+  struct uart_reg_map *uart = UART2_BASE;
+  uart -> CR1 |= CR1_TXEIE;
+#endif
+}
+
+/**
+ * @brief Sends pending log records if the transmitter is idle. Called from
+ *        SysTick, since logging itself never touches the hardware.
+ */
+void uart_tx_poll(){
+  if (deflog_pending()){
+    uart_tx_start();
+  }
+}
+
 /**
  * @brief Transmits a single byte via UART.
  *
- * Adds the byte to the `TransmitBuffer` and enables the transmit interrupt.
+ * Adds the byte to the `TransmitBuffer` of the caller's band and starts
+ * transmission. Lock-free, so interrupts stay enabled.
  *
  * @param[in] c The character to transmit.
  * @return 0 on success, -1 if the buffer is full.
  */
 int uart_put_byte(char c){
-  state = save_interrupt_state_and_disable();
-  if (TransmitBuffer.count == size_of_Queue){
-    restore_interrupt_state(state);
+  if (ring_mpsc_push(&TransmitBuffer[uart_tx_band()], c) < 0){
     return -1;
   }
 
-  struct uart_reg_map *uart = UART2_BASE;
-  if (TransmitBuffer.count == 0){
-    
-    enqueue(c, &TransmitBuffer);
-    
-    uart -> CR1 |= CR1_TXEIE;
-  
+  uart_tx_start();
+  return 0;
+}
+
+/**
+ * @brief Queues as much of a buffer as fits in one go.
+ *
+ * The bytes are copied into the ring once, as one record, and go out
+ * without the CPU touching them again.
+ *
+ * @param[in] buf The bytes to transmit.
+ * @param[in] len Number of bytes.
+ * @return Number of bytes queued, 0 if the ring is full.
+ */
+int uart_write(const char *buf, int len){
+  ring_buffer_t *rb = &TransmitBuffer[uart_tx_band()];
+  uint32_t n = ring_free(rb);
+  if ((uint32_t)len < n){
+    n = len;
+  }
+  if (n == 0){
+    return 0;
+  }
+
+  /* Another producer may have taken the space, the caller then retries */
+  n = ring_mpsc_push_batch(rb, (const uint8_t *)buf, n);
+  if (n != 0){
+    uart_tx_start();
+  }
+  return n;
+}
 
+/**
+ * @brief Queues a buffer as one record, all or nothing, so it goes out
+ *        without output of the same band in the middle.
+ *
+ * A buffer larger than the ring could never fit, only its first ring's
+ * worth is queued then.
+ *
+ * @param[in] buf The bytes to transmit.
+ * @param[in] len Number of bytes.
+ * @return Number of bytes queued, 0 if there is no room for them yet.
+ */
+int uart_write_record(const char *buf, int len){
+  ring_buffer_t *rb = &TransmitBuffer[uart_tx_band()];
+  uint32_t n = len;
+  if (n > rb -> mask + 1){
+    n = rb -> mask + 1;
   }
-  else{
-    enqueue(c, &TransmitBuffer);
+
+  n = ring_mpsc_push_batch(rb, (const uint8_t *)buf, n);
+  if (n != 0){
+    uart_tx_start();
   }
+  return n;
+}
+
+/**
+ * @brief Sleeps until the transmit ring of the caller's band has room for
+ *        a batch. Only output of the same band or above is sent before it.
+ *
+ * The check and the enqueue happen with interrupts disabled, so the
+ * interrupt that frees the space cannot slip in between.
+ *
+ * @return 0 once there is space, -1 if the caller may not sleep (before
+ *         the scheduler runs, or the idle thread); it then has to poll.
+ */
+int uart_wait_writable(){
+  uint32_t band = uart_tx_band();
+  int state = save_interrupt_state_and_disable();
+
+  if (ring_free(&TransmitBuffer[band]) >= TX_WAKE_SPACE){
+    restore_interrupt_state(state);
+    return 0;
+  }
+
+  int err = wait_queue_enqueue(&uart_tx_waiters[band], WAIT_FOREVER);
   restore_interrupt_state(state);
-  return 0;
-  
-  
+  if (err < 0){
+    return err;
+  }
+  return wait_queue_sleep();
+}
+
+/**
+ * @brief DMA1 Stream6 interrupt handler.
+ *
+ * At half transfer the bytes the stream has already read are given back to
+ * the ring, so writers do not wait for the whole chunk. At transfer
+ * complete the rest is given back and the next chunk is started.
+ */
+void DMA1_Stream6_IRQHandler() {
+  itm_isr_enter();
+#if UART_TX_DMA
+  struct dma_reg_map *dma = DMA1_BASE;
+  struct dma_stream_map *stream = &dma -> S[UART_TX_DMA_STREAM];
+  uint32_t flags = (dma -> HISR >> DMA_FLAG_SHIFT(UART_TX_DMA_STREAM)) & DMA_ALL_FLAGS;
+  dma -> HIFCR = flags << DMA_FLAG_SHIFT(UART_TX_DMA_STREAM);
+  uint32_t band = tx_dma_band;
+
+  if (band == UART_TX_LOG){
+    /* Log chunks are short, they are only given back once sent */
+    if (flags & DMA_TCIF){
+      deflog_consume(tx_dma_len);
+      tx_dma_len = 0;
+      uart_tx_kick();
+    }
+  }
+  else if (flags & DMA_TCIF){
+    ring_consume(&TransmitBuffer[band], tx_dma_len - tx_dma_released);
+    tx_dma_len = 0;
+    uart_tx_kick();
+    uart_wake_writers(band);
+  }
+  else if ((flags & DMA_HTIF) && tx_dma_len != 0){
+    uint32_t sent = tx_dma_len - stream -> NDTR;
+    ring_consume(&TransmitBuffer[band], sent - tx_dma_released);
+    tx_dma_released = sent;
+    uart_wake_writers(band);
+  }
+#endif
+  nvic_clear_pending(UART_TX_DMA_IRQ);
+  itm_isr_exit();
 }
 
 /**
  * @brief UART transmit interrupt handler.
  *
- * Handles the transmission of data from the `TransmitBuffer` to the UART data register.
+ * Handles the transmission of data from the highest band `TransmitBuffer`
+ * with data to the UART data register, or of log records if there is no
+ * text to send.
  */
 void USART2_TX_IRQHandler() {
-  state = save_interrupt_state_and_disable();
   struct uart_reg_map *uart = UART2_BASE;
-  char c;
-  if (TransmitBuffer.count == 1){
-    c = dequeue(&TransmitBuffer);
-    uart -> CR1 &= ~CR1_TXEIE;
+  uint8_t c;
+  const uint8_t *data;
+  int band = deflog_in_record() ? -1 : uart_tx_next_band();
+
+  if (band >= 0 && ring_pop(&TransmitBuffer[band], &c) == 0){
+    uart_wake_writers(band);
+  }
+  else if (deflog_peek(&data, 1) != 0){
+    c = *data;
+    deflog_consume(1);
   }
-  else{
-    c = dequeue(&TransmitBuffer);
+  else {
+    uart -> CR1 &= ~CR1_TXEIE;
+    return;
   }
   uart -> DR = c;
-  restore_interrupt_state(state);
+  if (uart_tx_pending() == 0 && !deflog_pending()){
+    uart -> CR1 &= ~CR1_TXEIE;
+  }
   return;
 }
 
+#if UART_RX_DMA
+/**
+ * @brief Publishes the bytes the DMA stream wrote since the last call.
+ *
+ * The stream writes at size - NDTR. Calls happen at least every half
+ * buffer, so the distance from head is never ambiguous. Bytes beyond one
+ * ring full of unread data were overwritten and are counted as overruns.
+ */
+static void uart_rx_sync(){
+  int state = save_interrupt_state_and_disable();
+
+  struct dma_stream_map *stream = &(DMA1_BASE) -> S[UART_RX_DMA_STREAM];
+  uint32_t pos = size_of_RxQueue - stream -> NDTR;
+  uint32_t head = ReceiveBuffer.head;
+  uint32_t written = (pos - head) & ReceiveBuffer.mask;
+
+  if (written != 0){
+    ring_produce(&ReceiveBuffer, written);
+    uint32_t count = ring_count(&ReceiveBuffer);
+    if (count > size_of_RxQueue){
+      uart_rx_overruns += count - size_of_RxQueue;
+    }
+    uart_wake_readers();
+  }
+
+  restore_interrupt_state(state);
+}
+
+/**
+ * @brief Skips the unread bytes the DMA stream already overwrote. Consumer
+ *        side.
+ */
+static void uart_rx_skip_overrun(){
+  uint32_t count = ring_count(&ReceiveBuffer);
+  if (count > size_of_RxQueue){
+    ring_consume(&ReceiveBuffer, count - size_of_RxQueue);
+  }
+}
+#endif
+
 /**
  * @brief Receives a single byte via UART.
  *
- * Retrieves a byte from the `ReceiveBuffer`.
+ * Retrieves a byte from the `ReceiveBuffer`. With DMA reception the bytes
+ * of a frame that is still coming in are picked up as well.
  *
  * @param[out] c Pointer to store the received character.
  * @return 0 on success, -1 if the buffer is empty.
  */
 int uart_get_byte(char *c){
-
-  if (ReceiveBuffer.count == 0){
-    return -1;
+#if UART_RX_DMA
+  if (ring_count(&ReceiveBuffer) == 0){
+    uart_rx_sync();
   }
-  
-  struct uart_reg_map *uart = UART2_BASE;
-  char str;
-  if (ReceiveBuffer.count == size_of_Queue){
-    str = dequeue(&ReceiveBuffer);
-    uart -> CR1 |= CR1_RXNEIE;
+  uart_rx_skip_overrun();
+#endif
+  return ring_pop(&ReceiveBuffer, (uint8_t *)c);
+}
+
+/**
+ * @brief Receives up to len bytes via UART without waiting.
+ *
+ * @param[out] buf Where to store the bytes.
+ * @param[in] len Maximum number of bytes.
+ * @return Number of bytes received.
+ */
+int uart_read(char *buf, int len){
+#if UART_RX_DMA
+  uart_rx_sync();
+  uart_rx_skip_overrun();
+#endif
+  return ring_pop_batch(&ReceiveBuffer, (uint8_t *)buf, len);
+}
+
+/**
+ * @brief Sleeps until the receive ring has data.
+ *
+ * @return 0 once there is data, -1 if the caller may not sleep (before the
+ *         scheduler runs, or the idle thread); it then has to poll.
+ */
+int uart_wait_readable(){
+  int state = save_interrupt_state_and_disable();
+
+#if UART_RX_DMA
+  uart_rx_sync();
+#endif
+  if (ring_count(&ReceiveBuffer) != 0){
+    restore_interrupt_state(state);
+    return 0;
   }
-  else{
-    
-    str = dequeue(&ReceiveBuffer);
+
+  int err = wait_queue_enqueue(&uart_rx_waiters, WAIT_FOREVER);
+  restore_interrupt_state(state);
+  if (err < 0){
+    return err;
   }
-  *c = str;
+  return wait_queue_sleep();
+}
 
-  return 0;
+/**
+ * @brief DMA1 Stream5 interrupt handler.
+ *
+ * Half and full buffer marks publish long frames before the DMA laps the
+ * reader; short frames are published by the IDLE line interrupt.
+ */
+void DMA1_Stream5_IRQHandler() {
+  itm_isr_enter();
+#if UART_RX_DMA
+  struct dma_reg_map *dma = DMA1_BASE;
+  uint32_t flags = (dma -> HISR >> DMA_FLAG_SHIFT(UART_RX_DMA_STREAM)) & DMA_ALL_FLAGS;
+  dma -> HIFCR = flags << DMA_FLAG_SHIFT(UART_RX_DMA_STREAM);
+  uart_rx_sync();
+#endif
+  nvic_clear_pending(UART_RX_DMA_IRQ);
+  itm_isr_exit();
 }
 
 
 /**
  * @brief UART receive interrupt handler.
  *
- * Handles the reception of data from the UART data register into the `ReceiveBuffer`.
+ * Handles the reception of data from the UART data register into the
+ * `ReceiveBuffer`. Reading DR clears RXNE, so when the buffer is full the
+ * byte is dropped and counted instead of masking the interrupt.
  */
 void USART2_RX_IRQHandler() {
   
@@ -273,13 +844,10 @@ void USART2_RX_IRQHandler() {
 
   char c = uart -> DR & 0xFF;
 
-  if (ReceiveBuffer.count == size_of_Queue - 1){
-    enqueue(c, &ReceiveBuffer);
-    uart->CR1 &= ~CR1_RXNEIE;
-  }
-  else{
-    enqueue(c, &ReceiveBuffer);
+  if (ring_spsc_push(&ReceiveBuffer, c) < 0){
+    uart_rx_overruns++;
   }
+  uart_wake_readers();
   
   return;
 }
@@ -290,43 +858,53 @@ void USART2_RX_IRQHandler() {
  * Handles both transmit and receive interrupts for UART2.
  */
 void USART2_IRQHandler() {
+  itm_isr_enter();
   struct uart_reg_map *uart = UART2_BASE;
-  int execute_RX = (uart -> SR & SR_RECEIVEREADY) && (ReceiveBuffer.count < size_of_Queue);
-  int execute_TX = (uart -> SR & SR_TRANSMITREADY) && (TransmitBuffer.count > 0);
-  if (execute_RX && execute_TX){
+  uint32_t sr = uart -> SR;
+  if ((sr & SR_RECEIVEREADY) && (uart -> CR1 & CR1_RXNEIE)){
     USART2_RX_IRQHandler();
-    USART2_TX_IRQHandler();
   }
-  else if(execute_TX){
+#if UART_RX_DMA
+  if (sr & SR_IDLE){
+    /* End of a frame, reading DR after SR clears IDLE */
+    (void)uart -> DR;
+    uart_rx_sync();
+  }
+#endif
+  if ((sr & SR_TRANSMITREADY) && (uart -> CR1 & CR1_TXEIE)){
     USART2_TX_IRQHandler();
   }
-  else {
-    USART2_RX_IRQHandler();
-    }
   nvic_clear_pending(38);  
+  itm_isr_exit();
   
 }
 
 /**
  * @brief Flushes the UART buffers.
  *
- * Clears the `TransmitBuffer` and `ReceiveBuffer` and disables UART interrupts.
+ * Waits for the `TransmitBuffer` to drain, clears both buffers and disables
+ * UART interrupts.
  */
 void uart_flush(){
   struct uart_reg_map *uart = UART2_BASE;
 
-  while (TransmitBuffer.count > 0){
+  uart_tx_start();
+  while (uart_tx_pending() > 0 || deflog_pending()){
     
   }
 
-  ReceiveBuffer.count = 0;
-  ReceiveBuffer.header = 0;
-  ReceiveBuffer.tail = 0;
-  
-  TransmitBuffer.count = 0;
-  TransmitBuffer.header = 0;
-  TransmitBuffer.tail = 0;
-
   uart -> CR1 &= ~CR1_RXNEIE;
   uart -> CR1 &= ~CR1_TXEIE;
+#if UART_RX_DMA
+  uart -> CR1 &= ~CR1_IDLEIE;
+  uart -> CR3 &= ~CR3_DMAR;
+  (DMA1_BASE) -> S[UART_RX_DMA_STREAM].CR &= ~DMA_SxCR_EN;
+  nvic_irq(UART_RX_DMA_IRQ, IRQ_DISABLE);
+#endif
+#if UART_TX_DMA
+  uart -> CR3 &= ~CR3_DMAT;
+  nvic_irq(UART_TX_DMA_IRQ, IRQ_DISABLE);
+#endif
+
+  initBuffer();
 }
\ No newline at end of file
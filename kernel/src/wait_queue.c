@@ -0,0 +1,219 @@
+/**
+ * @file wait_queue.c
+ *
+ * @brief Priority ordered wait queues. Every blocking kernel object embeds a
+ *        wait_queue_t and uses these helpers to put the calling thread to
+ *        sleep and to wake it back up from a syscall or an ISR.
+ *
+ * @date  October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <wait_queue.h>
+#include <syscall_thread.h>
+#include <systick.h>
+#include <arm.h>
+#include <debug.h>
+
+/**
+ * @brief Bitmap of the threads sleeping with a finite timeout.
+ */
+static volatile uint32_t timed_waiters;
+
+/**
+ * @brief Initializes a wait queue with no waiters.
+ *
+ * @param[in] wq The wait queue.
+ */
+void wait_queue_init(wait_queue_t *wq){
+  wq->waiters = 0;
+}
+
+/**
+ * @brief Suspends the current thread on a wait queue.
+ *
+ * The thread is only marked, the actual switch happens in wait_queue_sleep()
+ * once the caller has restored interrupts.
+ *
+ * @param[in] wq The wait queue.
+ * @param[in] timeout Ticks to wait at most, WAIT_FOREVER for no limit.
+ * @return 0 on success, WAIT_TIMEOUT for a zero timeout, -1 if the current
+ *         thread may not block.
+ */
+int wait_queue_enqueue(wait_queue_t *wq, uint32_t timeout){
+  uint32_t current_thread = global_threads_info.current_thread;
+
+  /* The idle thread and the default thread have nothing to fall back to */
+  if (current_thread >= global_threads_info.max_threads){
+    return -1;
+  }
+
+  if (timeout == 0){
+    return WAIT_TIMEOUT;
+  }
+
+  TCB_t *TCB = &TCB_ARRAY[current_thread];
+
+  /* Every wait ends with a wake, which takes the thread off its queue */
+  ASSERT(TCB->wait_queue == NULL);
+
+  TCB->wait_status = WAIT_OK;
+  TCB->wait_queue = wq;
+  TCB->state = SUSPENDED;
+  wq->waiters |= (1 << current_thread);
+
+  if (timeout != WAIT_FOREVER){
+    TCB->wait_deadline = systick_get_ticks() + timeout;
+    timed_waiters |= (1 << current_thread);
+  }
+  else {
+    /* No deadline left over from an earlier wait may time this one out */
+    timed_waiters &= ~(1 << current_thread);
+  }
+  return 0;
+}
+
+/**
+ * @brief Switches away from the suspended current thread.
+ *
+ * PendSV has a higher priority than SVC, so it is taken as soon as it is
+ * pended and we only come back here once the thread has been picked by the
+ * scheduler again. Only a wake takes the thread off its queue, so that is
+ * what ends the wait: if anything else made the thread runnable, it goes
+ * back to sleep.
+ *
+ * @return The status handed over by the waker.
+ */
+int32_t wait_queue_sleep(){
+  uint32_t current_thread = global_threads_info.current_thread;
+  volatile TCB_t *TCB = &TCB_ARRAY[current_thread];
+
+  while (1){
+    /* wait_queue_move() changes the queue, read it with its bitmap */
+    int state = save_interrupt_state_and_disable();
+    wait_queue_t *wq = TCB->wait_queue;
+    if (wq == NULL || !(wq->waiters & (1 << current_thread))){
+      restore_interrupt_state(state);
+      break;
+    }
+    TCB->state = SUSPENDED;
+    pend_pendsv();
+    restore_interrupt_state(state);
+  }
+
+  return TCB->wait_status;
+}
+
+/**
+ * @brief Wakes a given thread sleeping on a wait queue.
+ *
+ * @param[in] wq The wait queue.
+ * @param[in] thread Index of the thread to wake.
+ * @param[in] status Status to hand over to the thread.
+ */
+void wait_queue_wake_thread(wait_queue_t *wq, uint32_t thread, int32_t status){
+  int state = save_interrupt_state_and_disable();
+
+  if (wq->waiters & (1 << thread)){
+    wq->waiters &= ~(1 << thread);
+    timed_waiters &= ~(1 << thread);
+    TCB_ARRAY[thread].wait_queue = NULL;
+    /* A thread waits on one object at a time, so it is no longer waiting
+     * for any mutex and the scheduler may pick it again */
+    TCB_ARRAY[thread].waiting_mutex_bitmap = 0;
+    TCB_ARRAY[thread].wait_status = status;
+    TCB_ARRAY[thread].state = READY;
+    pend_pendsv();
+  }
+
+  restore_interrupt_state(state);
+}
+
+/**
+ * @brief Wakes the highest priority thread sleeping on a wait queue.
+ *
+ * The lowest set bit is the highest priority waiter, so this is a single
+ * count-trailing-zeros (rbit + clz) regardless of how many threads wait.
+ *
+ * @param[in] wq The wait queue.
+ * @param[in] status Status to hand over to the thread.
+ * @return The index of the woken thread, -1 if there were no waiters.
+ */
+int wait_queue_wake_one(wait_queue_t *wq, int32_t status){
+  int state = save_interrupt_state_and_disable();
+  int thread = -1;
+
+  if (wq->waiters != 0){
+    thread = __builtin_ctz(wq->waiters);
+    wait_queue_wake_thread(wq, thread, status);
+  }
+
+  restore_interrupt_state(state);
+  return thread;
+}
+
+/**
+ * @brief Wakes all the threads sleeping on a wait queue.
+ *
+ * @param[in] wq The wait queue.
+ * @param[in] status Status to hand over to every thread.
+ * @return The number of threads woken.
+ */
+uint32_t wait_queue_wake_all(wait_queue_t *wq, int32_t status){
+  uint32_t woken = 0;
+  while (wait_queue_wake_one(wq, status) >= 0){
+    woken++;
+  }
+  return woken;
+}
+
+/**
+ * @brief Moves a sleeping thread to another wait queue without waking it.
+ *
+ * The thread keeps sleeping and no longer has a timeout, since what it waits
+ * for now is a different event.
+ *
+ * @param[in] from The wait queue the thread sleeps on.
+ * @param[in] to The wait queue to move it to.
+ * @param[in] thread Index of the thread to move.
+ * @return 0 on success, -1 if the thread was not sleeping on from.
+ */
+int wait_queue_move(wait_queue_t *from, wait_queue_t *to, uint32_t thread){
+  int state = save_interrupt_state_and_disable();
+  int err = -1;
+
+  if (from->waiters & (1 << thread)){
+    from->waiters &= ~(1 << thread);
+    timed_waiters &= ~(1 << thread);
+    to->waiters |= (1 << thread);
+    TCB_ARRAY[thread].wait_queue = to;
+    err = 0;
+  }
+
+  restore_interrupt_state(state);
+  return err;
+}
+
+/**
+ * @brief Times out the waiters whose deadline has passed.
+ *
+ * Runs from SysTick, so the scan is bounded by the number of threads and
+ * costs nothing when no thread is in a timed wait.
+ *
+ * @param[in] now Current tick count.
+ */
+void wait_queue_tick(uint32_t now){
+  uint32_t pending = timed_waiters;
+
+  while (pending != 0){
+    uint32_t thread = __builtin_ctz(pending);
+    pending &= ~(1 << thread);
+
+    /* Wrap safe comparison of the deadline against now */
+    if ((int32_t)(now - TCB_ARRAY[thread].wait_deadline) >= 0){
+      wait_queue_wake_thread(TCB_ARRAY[thread].wait_queue, thread, WAIT_TIMEOUT);
+    }
+  }
+}
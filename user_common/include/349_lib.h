@@ -49,7 +49,8 @@ intrinsic void wait_for_interrupt( void ) {
 
 /**
  * @brief       Pretends to do work until the given time is past.
- *              For grading.
+ *              For grading. Use sleep_until() to wait without
+ *              holding the CPU.
  *
  * @param time  time at which to stop "working"
  */
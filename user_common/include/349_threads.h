@@ -11,6 +11,15 @@
 
 #include <stdint.h>
 
+/** @brief Timeout value for blocking calls that never expires. */
+#define WAIT_FOREVER 0xFFFFFFFF
+
+/** @brief Error returned by blocking calls whose timeout expired. */
+#define ERR_TIMEOUT (-2)
+
+/** @brief Error returned by a mutex lock that would deadlock. */
+#define ERR_DEADLOCK (-3)
+
 typedef enum { PER_THREAD = 1, KERNEL_ONLY = 0 } memory_protection_t;
 
 /**
@@ -78,6 +87,16 @@ int scheduler_start( uint32_t frequency );
  */
 uint32_t get_time( void );
 
+/**
+ * @brief      Get the monotonic time with microsecond resolution.
+ *
+ *             Unlike get_time() this does not wrap after 49 days and
+ *             resolves time within a tick.
+ *
+ * @return     The time in microseconds since the scheduler started.
+ */
+uint64_t get_time_us( void );
+
 /**
  * @brief      Get the effective priority of the current running thread
  *
@@ -93,11 +112,51 @@ uint32_t get_priority( void );
  */
 uint32_t thread_time( void );
 
+/**
+ * @brief      Gets the CPU time the thread has used, in processor cycles.
+ *
+ *             Measured at every context switch, so time spent blocked or
+ *             preempted mid tick is not counted. thread_time() is this
+ *             value in whole ticks.
+ *
+ * @return     The CPU time in cycles.
+ */
+uint64_t thread_time_cycles( void );
+
+/**
+ * @brief      Gets the CPU time the thread has used, in microseconds.
+ *
+ * @return     The CPU time in microseconds.
+ */
+uint64_t thread_time_us( void );
+
 /**
  * @brief      Waits efficiently by descheduling thread.
  */
 void wait_until_next_period( void );
 
+/**
+ * @brief      Sleep until an absolute time
+ *
+ *             Unlike spin_until() the thread is descheduled and not charged
+ *             while it sleeps, so lower priority threads or idle run.
+ *
+ * @param      tick  The time in ticks to wake up at. Returns at once if it
+ *                   has already passed.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int sleep_until( uint32_t tick );
+
+/**
+ * @brief      Sleep for a number of ticks
+ *
+ * @param      ticks  How long to sleep, in ticks.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int sleep_for( uint32_t ticks );
+
 /**
  * @brief      Type definition for mutex, opaque to user
  */
@@ -120,12 +179,60 @@ mutex_t *mutex_init( uint32_t max_prio );
  * @brief      Lock a mutex
  *
  *             This function will not return until the current thread has
- *             obtained the mutex.
+ *             obtained the mutex. If waiting would deadlock, a thread of
+ *             the cycle is killed, by default the caller. Code that can back
+ *             off from a deadlock should use mutex_lock_timed() and check
+ *             for ERR_DEADLOCK.
  *
  * @param      mutex  The mutex to act on.
  */
 void mutex_lock( mutex_t *mutex );
 
+/**
+ * @brief      Lock a mutex, giving up after timeout ticks
+ *
+ *             The calling thread is descheduled until the mutex is handed to
+ *             it or the timeout expires, whichever comes first.
+ *
+ * @param      mutex    The mutex to act on.
+ * @param      timeout  Ticks to wait, 0 to try once, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 once the mutex is held, ERR_TIMEOUT if it was not obtained
+ *             in time, ERR_DEADLOCK if waiting would deadlock or -1 on
+ *             failure
+ */
+int mutex_lock_timed( mutex_t *mutex, uint32_t timeout );
+
+/**
+ * @brief      Declare the longest critical section a thread runs on a mutex
+ *
+ *             The kernel uses the declarations to add IPCP blocking to the UB
+ *             test, so declare before creating the threads involved. At
+ *             runtime, unlocking after holding a mutex longer than declared
+ *             prints a warning.
+ *
+ * @param      mutex     The mutex to act on.
+ * @param      prio      Priority of the thread that locks the mutex.
+ * @param      cs_ticks  Longest time the thread holds the mutex (ticks).
+ *
+ * @return     0 on success or -1 if the thread can never lock the mutex or
+ *             the threads created so far would fail the UB test
+ */
+int mutex_declare( mutex_t *mutex, uint32_t prio, uint32_t cs_ticks );
+
+/**
+ * @brief      Print the contention and hold time counters of every mutex
+ *
+ *             One line per mutex: acquisitions, contended acquisitions,
+ *             average and longest hold time, the thread that held it
+ *             longest, and average and longest wait time, all in cycles.
+ *
+ * @return     0 on success or -1 if the kernel was built without
+ *             MUTEX_PROFILING
+ */
+int mutex_profile_dump( void );
+
 /**
  * @brief      Unlock a mutex
  *
@@ -133,4 +240,489 @@ void mutex_lock( mutex_t *mutex );
  */
 void mutex_unlock( mutex_t *mutex );
 
+/**
+ * @brief      Type definition for a condition variable, opaque to user
+ */
+typedef void cond_t;
+
+/**
+ * @brief      Initialize a condition variable
+ *
+ * @param      mutex  The mutex that protects the predicate. Every waiter
+ *                    must hold it.
+ *
+ * @return     A condition variable handle. NULL if none are left.
+ */
+cond_t *cond_init( mutex_t *mutex );
+
+/**
+ * @brief      Release the mutex and wait for a signal
+ *
+ *             The release and the wait are atomic, so no signal is lost in
+ *             between. The caller's priority drops back from the mutex
+ *             ceiling while it waits, and the mutex is held again when this
+ *             returns 0 or ERR_TIMEOUT. The caller must not hold any other
+ *             mutex. Recheck the predicate in a loop after waking.
+ *
+ * @param      cond     The condition variable to wait on.
+ * @param      timeout  Ticks to wait for a signal, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 when signalled, ERR_TIMEOUT if no signal came in time or -1
+ *             on misuse
+ */
+int cond_wait( cond_t *cond, uint32_t timeout );
+
+/**
+ * @brief      Wake the highest priority waiter
+ *
+ * @param      cond  The condition variable to signal.
+ *
+ * @return     Number of threads woken
+ */
+uint32_t cond_signal( cond_t *cond );
+
+/**
+ * @brief      Wake every waiter, in priority order
+ *
+ * @param      cond  The condition variable to signal.
+ *
+ * @return     Number of threads woken
+ */
+uint32_t cond_broadcast( cond_t *cond );
+
+/**
+ * @brief      Type definition for counting semaphore, opaque to user
+ */
+typedef void semaphore_t;
+
+/**
+ * @brief      Initialize a counting semaphore
+ *
+ * @param      count      The initial number of units.
+ * @param      max_count  The largest value the count may reach.
+ *
+ * @return     A semaphore handle. NULL if no semaphores are left or the
+ *             counts are invalid.
+ */
+semaphore_t *semaphore_init( uint32_t count, uint32_t max_count );
+
+/**
+ * @brief      Take a unit from a semaphore
+ *
+ *             The calling thread is descheduled until a unit is available,
+ *             waiters are served highest priority first.
+ *
+ * @param      sem  The semaphore to act on.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int semaphore_wait( semaphore_t *sem );
+
+/**
+ * @brief      Take a unit from a semaphore, giving up after timeout ticks
+ *
+ * @param      sem      The semaphore to act on.
+ * @param      timeout  Ticks to wait, 0 to poll, WAIT_FOREVER for no limit.
+ *
+ * @return     0 on success, ERR_TIMEOUT if no unit arrived in time or -1 on
+ *             failure
+ */
+int semaphore_wait_timed( semaphore_t *sem, uint32_t timeout );
+
+/**
+ * @brief      Take a unit from a semaphore without blocking
+ *
+ * @param      sem  The semaphore to act on.
+ *
+ * @return     0 on success or -1 if no unit was available
+ */
+int semaphore_try_wait( semaphore_t *sem );
+
+/**
+ * @brief      Release a unit to a semaphore
+ *
+ * @param      sem  The semaphore to act on.
+ *
+ * @return     0 on success or -1 if the semaphore is already full
+ */
+int semaphore_post( semaphore_t *sem );
+
+/**
+ * @brief      Type definition for a 32-bit event flag group, opaque to user
+ */
+typedef void event_t;
+
+/** @brief Options for event_wait() */
+//@{
+#define EVENT_WAIT_ANY 0x0  /**< Wake when any bit of the mask is set. */
+#define EVENT_WAIT_ALL 0x1  /**< Wake when every bit of the mask is set. */
+#define EVENT_CLEAR    0x2  /**< Consume the matched bits on wakeup. */
+//@}
+
+/**
+ * @brief      Initialize an event flag group with every flag cleared
+ *
+ * @return     An event group handle. NULL if no groups are left.
+ */
+event_t *event_init( void );
+
+/**
+ * @brief      Wait for flags of an event group
+ *
+ * @param      event      The event group to act on.
+ * @param      mask       The flags to wait for.
+ * @param      options    EVENT_WAIT_ANY or EVENT_WAIT_ALL, optionally or-ed
+ *                        with EVENT_CLEAR.
+ * @param      flags_out  If not NULL, receives the flags that satisfied the
+ *                        wait.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int event_wait( event_t *event, uint32_t mask, uint32_t options,
+                uint32_t *flags_out );
+
+/**
+ * @brief      Wait for flags of an event group, giving up after timeout ticks
+ *
+ * @param      event      The event group to act on.
+ * @param      mask       The flags to wait for.
+ * @param      options    Same as event_wait().
+ * @param      flags_out  Same as event_wait().
+ * @param      timeout    Ticks to wait, 0 to poll, WAIT_FOREVER for no limit.
+ *
+ * @return     0 on success, ERR_TIMEOUT if the flags were not set in time or
+ *             -1 on failure
+ */
+int event_wait_timed( event_t *event, uint32_t mask, uint32_t options,
+                      uint32_t *flags_out, uint32_t timeout );
+
+/**
+ * @brief      Set flags of an event group, waking the satisfied waiters
+ *
+ * @param      event  The event group to act on.
+ * @param      mask   The flags to set.
+ *
+ * @return     The flags still set after the waiters consumed theirs
+ */
+uint32_t event_set( event_t *event, uint32_t mask );
+
+/**
+ * @brief      Clear flags of an event group
+ *
+ * @param      event  The event group to act on.
+ * @param      mask   The flags to clear.
+ *
+ * @return     The flags still set
+ */
+uint32_t event_clear( event_t *event, uint32_t mask );
+
+/**
+ * @brief      Type definition for a software timer, opaque to user
+ */
+typedef void swtimer_t;
+
+/**
+ * @brief      Create a software timer
+ *
+ *             Timers run off the kernel tick and do not use a thread slot.
+ *
+ * @param      event  Event group whose flags are set on expiry, or NULL for
+ *                    a timer that wakes the threads blocked in
+ *                    swtimer_wait().
+ * @param      mask   The flags to set on the event group.
+ *
+ * @return     A timer handle. NULL if no timers are left.
+ */
+swtimer_t *swtimer_create( event_t *event, uint32_t mask );
+
+/**
+ * @brief      Arm a software timer, re-arming it if it is already armed
+ *
+ * @param      timer   The timer to act on.
+ * @param      delay   Ticks until the first expiry, at least 1.
+ * @param      period  Ticks between later expiries, 0 for one-shot.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int swtimer_start( swtimer_t *timer, uint32_t delay, uint32_t period );
+
+/**
+ * @brief      Disarm a software timer
+ *
+ * @param      timer  The timer to act on.
+ *
+ * @return     1 if the timer was armed, 0 otherwise
+ */
+int swtimer_cancel( swtimer_t *timer );
+
+/**
+ * @brief      Wait for a timer created without an event group to expire
+ *
+ *             Expirations that happened while nobody waited are not lost,
+ *             the next call returns at once with how many there were.
+ *
+ * @param      timer    The timer to wait on.
+ * @param      timeout  Ticks to wait, 0 to poll, WAIT_FOREVER for no limit.
+ *
+ * @return     Number of expirations, ERR_TIMEOUT if none came in time or -1
+ *             on failure
+ */
+int swtimer_wait( swtimer_t *timer, uint32_t timeout );
+
+/**
+ * @brief      Type definition for a zero-copy message queue, opaque to user
+ */
+typedef void msgq_t;
+
+/**
+ * @brief      Initialize a message queue of fixed-size blocks
+ *
+ *             The blocks live in user supplied storage, messages are filled
+ *             and read in place and never copied by the kernel.
+ *
+ * @param      buffer      Storage for num_blocks * block_size bytes.
+ * @param      block_size  The size of one message in bytes.
+ * @param      num_blocks  The number of blocks, at most 32.
+ *
+ * @return     A queue handle. NULL if no queues are left or the arguments
+ *             are invalid.
+ */
+msgq_t *msgq_init( void *buffer, uint32_t block_size, uint32_t num_blocks );
+
+/**
+ * @brief      Reserve a free block to fill
+ *
+ * @param      q        The queue to act on.
+ * @param      block    Receives the address of the block.
+ * @param      timeout  Ticks to wait for a free block, 0 to poll or
+ *                      WAIT_FOREVER.
+ *
+ * @return     0 on success, ERR_TIMEOUT if the timeout expired or -1 on
+ *             failure
+ */
+int msgq_reserve( msgq_t *q, void **block, uint32_t timeout );
+
+/**
+ * @brief      Send a reserved block
+ *
+ * @param      q      The queue to act on.
+ * @param      block  A block obtained from msgq_reserve().
+ *
+ * @return     0 on success or -1 on failure
+ */
+int msgq_commit( msgq_t *q, void *block );
+
+/**
+ * @brief      Borrow the oldest message
+ *
+ * @param      q        The queue to act on.
+ * @param      block    Receives the address of the block.
+ * @param      timeout  Ticks to wait for a message, 0 to poll or
+ *                      WAIT_FOREVER.
+ *
+ * @return     0 on success, ERR_TIMEOUT if the timeout expired or -1 on
+ *             failure
+ */
+int msgq_receive( msgq_t *q, void **block, uint32_t timeout );
+
+/**
+ * @brief      Give a borrowed block back to the queue
+ *
+ * @param      q      The queue to act on.
+ * @param      block  A block obtained from msgq_receive().
+ *
+ * @return     0 on success or -1 on failure
+ */
+int msgq_release( msgq_t *q, void *block );
+
+/**
+ * @brief      Get the most blocks that were ever in use at once
+ *
+ * @param      q      The queue to act on.
+ *
+ * @return     The high-water mark in blocks
+ */
+uint32_t msgq_high_water( msgq_t *q );
+
+/**
+ * @brief      Type definition for a reader-writer lock, opaque to user
+ */
+typedef void rwlock_t;
+
+/**
+ * @brief      Initialize a reader-writer lock
+ *
+ *             Readers run at the read ceiling and writers at the write
+ *             ceiling, so readers above the read ceiling never block each
+ *             other.
+ *
+ * @param      read_ceil   Priority of the highest priority thread that
+ *                         writes.
+ * @param      write_ceil  Priority of the highest priority thread that reads
+ *                         or writes.
+ *
+ * @return     A lock handle. NULL if no locks are left or
+ *             write_ceil > read_ceil.
+ */
+rwlock_t *rwlock_init( uint32_t read_ceil, uint32_t write_ceil );
+
+/**
+ * @brief      Take a reader-writer lock for reading
+ *
+ * @param      rw       The lock to act on.
+ * @param      timeout  Ticks to wait, 0 to try once, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 on success, ERR_TIMEOUT if the lock was not obtained in time
+ *             or -1 on failure
+ */
+int rwlock_read_lock( rwlock_t *rw, uint32_t timeout );
+
+/**
+ * @brief      Take a reader-writer lock for writing
+ *
+ * @param      rw       The lock to act on.
+ * @param      timeout  Ticks to wait, 0 to try once, WAIT_FOREVER for no
+ *                      limit.
+ *
+ * @return     0 on success, ERR_TIMEOUT if the lock was not obtained in time
+ *             or -1 on failure
+ */
+int rwlock_write_lock( rwlock_t *rw, uint32_t timeout );
+
+/**
+ * @brief      Release a read or write hold on a reader-writer lock
+ *
+ * @param      rw  The lock to act on.
+ *
+ * @return     0 on success or -1 if the caller does not hold the lock
+ */
+int rwlock_unlock( rwlock_t *rw );
+
+/**
+ * @brief      Declare the longest read and write sections of a thread
+ *
+ *             Like mutex_declare(), the declarations add blocking terms to
+ *             the UB test. Declare before creating the threads involved.
+ *
+ * @param      rw           The lock to act on.
+ * @param      prio         Priority of the thread.
+ * @param      read_ticks   Longest read section (ticks), 0 if none.
+ * @param      write_ticks  Longest write section (ticks), 0 if none.
+ *
+ * @return     0 on success or -1 if the thread does not fit the ceilings or
+ *             the threads created so far would fail the UB test
+ */
+int rwlock_declare( rwlock_t *rw, uint32_t prio, uint32_t read_ticks,
+                    uint32_t write_ticks );
+
+/** @brief Flag for barrier_wait() and phase_wait(): also wait for the next
+ *         period, like wait_until_next_period() */
+#define RENDEZVOUS_NEXT_PERIOD 0x1
+
+/**
+ * @brief      Type definition for a barrier, opaque to user
+ */
+typedef void barrier_t;
+
+/**
+ * @brief      Type definition for a phase counter, opaque to user
+ */
+typedef void phase_t;
+
+/**
+ * @brief      Initialize a barrier
+ *
+ * @param      parties  Number of threads that must arrive each round.
+ *
+ * @return     A barrier handle. NULL if no barriers are left.
+ */
+barrier_t *barrier_init( uint32_t parties );
+
+/**
+ * @brief      Wait until every party has arrived at the barrier
+ *
+ *             All parties are released together and run in priority order.
+ *             With RENDEZVOUS_NEXT_PERIOD a thread is released at the later
+ *             of the round completing and its next period starting.
+ *
+ * @param      barrier  The barrier to act on.
+ * @param      flags    0 or RENDEZVOUS_NEXT_PERIOD.
+ *
+ * @return     1 for the thread that completed the round, 0 for the others
+ *             or -1 on failure
+ */
+int barrier_wait( barrier_t *barrier, uint32_t flags );
+
+/**
+ * @brief      Initialize a phase counter at 0
+ *
+ * @return     A phase handle. NULL if no phase counters are left.
+ */
+phase_t *phase_init( void );
+
+/**
+ * @brief      Mark a phase complete, e.g. when a pipeline stage is done with
+ *             its period. Never blocks.
+ *
+ * @param      phase  The phase counter to act on.
+ *
+ * @return     The new phase count
+ */
+uint32_t phase_signal( phase_t *phase );
+
+/**
+ * @brief      Wait until the phase counter reaches target
+ *
+ *             With RENDEZVOUS_NEXT_PERIOD this replaces
+ *             wait_until_next_period(): the thread is released at the later
+ *             of its next period and the upstream completing the phase.
+ *
+ * @param      phase   The phase counter to act on.
+ * @param      target  Phase count to wait for.
+ * @param      flags   0 or RENDEZVOUS_NEXT_PERIOD.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int phase_wait( phase_t *phase, uint32_t target, uint32_t flags );
+
+/**
+ * @brief      Change the baud rate of the console UART
+ *
+ *             Output written before the call is sent at the old rate. The
+ *             host side has to switch too.
+ *
+ * @param      baud  The new baud rate, up to 2000000 on the 16MHz clock.
+ *
+ * @return     0 on success or -1 if the rate cannot be generated closely
+ *             enough
+ */
+int uart_set_baud( uint32_t baud );
+
+/**
+ * @brief      Put a marker into the ITM trace, e.g. at the start and end of
+ *             a job, to line it up with the kernel events in
+ *             util/itm_timeline.c
+ *
+ * @param      id    Marker ID, 0 to 255.
+ *
+ * @return     0 on success or -1 if the kernel was built without ITM_TRACE
+ */
+int trace_marker( uint32_t id );
+
+/**
+ * @brief      Send the scheduler trace over the UART and start a new one
+ *
+ *             The kernel keeps the last SCHED_TRACE_RECORDS context
+ *             switches, releases, budget overruns and mutex operations in
+ *             RAM. Capture the console and turn it into a timeline with
+ *             util/sched_trace_json.c. The caller sleeps until the records
+ *             are queued.
+ *
+ * @return     Number of records sent or -1 if the kernel was built without
+ *             SCHED_TRACE
+ */
+int sched_trace_dump( void );
+
 #endif /* _SYSCALL_THREAD_H_ */
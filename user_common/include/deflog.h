@@ -0,0 +1,57 @@
+/** @file deflog.h
+ *
+ *  @brief  Deferred binary logging for user programs.
+ *
+ *          DEFLOG() stores the ID of its format string and its raw
+ *          arguments into a lock-free ring, with no formatting and no
+ *          syscall, so it costs tens of cycles where printf() costs
+ *          thousands. The kernel sends the records over the console
+ *          whenever no text is queued, and the host decoder renders them:
+ *
+ *            make decoder
+ *            build/deflog_decode build/bin/<binary>.elf < capture
+ *
+ *          Arguments are passed as 32 bits each, at most DEFLOG_MAX_ARGS,
+ *          so %s, %f and 64-bit conversions are not supported. Records
+ *          logged while the ring is full are dropped and counted.
+ */
+
+#ifndef _USER_DEFLOG_H_
+#define _USER_DEFLOG_H_
+
+#include "../../kernel/include/deflog.h"
+
+/** @brief Ring DEFLOG() writes into. */
+extern ring_buffer_t deflog_ring;
+
+/** @brief Records dropped because the ring was full. */
+extern volatile uint32_t deflog_dropped;
+
+/**
+ * @brief      Logs a record, e.g. DEFLOG( "t=%u x=%d", now, x ). Logging
+ *             before deflog_init() drops the record.
+ */
+#define DEFLOG( fmt, ... ) do { \
+  if ( deflog_record( &deflog_ring, fmt, ##__VA_ARGS__ ) < 0 ) { \
+    deflog_dropped++; \
+  } \
+} while ( 0 )
+
+/**
+ * @brief      Sets up the ring and hands it to the kernel.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int deflog_init( void );
+
+/**
+ * @brief      Registers a log ring with the kernel, which from then on
+ *             sends its records. deflog_init() does this for deflog_ring.
+ *
+ * @param      ring  An initialized ring, NULL to stop.
+ *
+ * @return     0 on success or -1 on failure
+ */
+int deflog_register( ring_buffer_t *ring );
+
+#endif /* _USER_DEFLOG_H_ */
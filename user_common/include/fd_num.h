@@ -0,0 +1 @@
+#include "../../kernel/include/fd_num.h"
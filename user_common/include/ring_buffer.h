@@ -0,0 +1 @@
+#include "../../kernel/include/ring_buffer.h"
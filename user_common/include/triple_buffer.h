@@ -0,0 +1,101 @@
+/** @file triple_buffer.h
+ *
+ *  @brief  Latest-value channel between one writer thread and one reader
+ *          thread, built on a triple buffer.
+ *
+ *          The writer always owns one slot, the reader owns another and the
+ *          third is the hand-over slot. Publishing swaps the writer's slot
+ *          with the hand-over slot, reading swaps the hand-over slot with
+ *          the reader's slot if it holds a newer sample. Both sides finish
+ *          in a bounded number of instructions, never block each other and
+ *          make no syscalls, so neither thread's priority changes the way it
+ *          would under an IPCP mutex.
+ *
+ *          Only the most recent sample is kept. Samples published between
+ *          two reads are overwritten, which is what a control loop reading a
+ *          faster sensor wants.
+ */
+
+#ifndef _TRIPLE_BUFFER_H_
+#define _TRIPLE_BUFFER_H_
+
+#include <stdint.h>
+
+/** @brief Bytes of storage needed for a channel of elem_size byte samples */
+#define TRIPLE_BUFFER_STORAGE( elem_size ) ( 3 * ( elem_size ) )
+
+/**
+ * @brief      Channel state. The writer owns back, the reader owns front and
+ *             front_valid, middle is shared and only ever swapped atomically.
+ */
+typedef struct {
+  uint8_t *storage;          /**< Three slots of size bytes each. */
+  uint32_t size;             /**< Size of one sample in bytes. */
+  volatile uint32_t middle;  /**< Hand-over slot index | TB_FRESH. */
+  uint32_t back;             /**< Slot the writer fills next. */
+  uint32_t front;            /**< Slot the reader last took. */
+  uint32_t front_valid;      /**< Whether front holds a published sample. */
+} triple_buffer_t;
+
+/**
+ * @brief      Initializes a channel over caller supplied storage.
+ *
+ * @param      tb         The channel.
+ * @param      storage    TRIPLE_BUFFER_STORAGE( size ) bytes, word aligned if
+ *                        samples are read in place.
+ * @param[in]  size       Size of one sample in bytes.
+ *
+ * @return     0 on success, -1 on invalid arguments.
+ */
+int triple_buffer_init( triple_buffer_t *tb, void *storage, uint32_t size );
+
+/**
+ * @brief      Writer: returns the slot to fill in place. The sample becomes
+ *             visible on triple_buffer_commit().
+ *
+ * @param      tb    The channel.
+ *
+ * @return     Pointer to size bytes owned by the writer.
+ */
+void *triple_buffer_write_begin( triple_buffer_t *tb );
+
+/**
+ * @brief      Writer: publishes the slot returned by
+ *             triple_buffer_write_begin().
+ *
+ * @param      tb    The channel.
+ */
+void triple_buffer_commit( triple_buffer_t *tb );
+
+/**
+ * @brief      Writer: copies a sample in and publishes it.
+ *
+ * @param      tb     The channel.
+ * @param[in]  value  size bytes to publish.
+ */
+void triple_buffer_publish( triple_buffer_t *tb, const void *value );
+
+/**
+ * @brief      Reader: takes the newest sample if there is one and returns a
+ *             pointer to it. The pointer stays valid until the next read.
+ *
+ * @param      tb     The channel.
+ * @param[out] fresh  If not NULL, set to 1 if a new sample was taken and 0 if
+ *                    the previous one was returned again.
+ *
+ * @return     Pointer to the newest sample, NULL if nothing was published.
+ */
+const void *triple_buffer_read_begin( triple_buffer_t *tb, int *fresh );
+
+/**
+ * @brief      Reader: copies the newest sample out.
+ *
+ * @param      tb     The channel.
+ * @param[out] value  size bytes to fill.
+ *
+ * @return     1 for a new sample, 0 for the same sample as the last read,
+ *             -1 if nothing was published yet.
+ */
+int triple_buffer_read( triple_buffer_t *tb, void *value );
+
+#endif /* _TRIPLE_BUFFER_H_ */
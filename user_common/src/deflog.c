@@ -0,0 +1,19 @@
+#include <deflog.h>
+#include <stddef.h>
+
+/** @brief Size of the user log ring, must be a power of two */
+#define DEFLOG_RING_SIZE 1024
+
+static uint8_t deflog_data[DEFLOG_RING_SIZE];
+
+ring_buffer_t deflog_ring;
+
+volatile uint32_t deflog_dropped;
+
+int deflog_init( void ) {
+  if ( ring_init( &deflog_ring, deflog_data, DEFLOG_RING_SIZE ) < 0 ) {
+    return -1;
+  }
+  deflog_dropped = 0;
+  return deflog_register( &deflog_ring );
+}
@@ -0,0 +1,94 @@
+#include <triple_buffer.h>
+#include <string.h>
+
+/** @brief Set in middle when it holds a sample the reader has not taken */
+#define TB_FRESH 0x4
+
+/** @brief Mask of the slot index in middle */
+#define TB_INDEX 0x3
+
+/**
+ * @brief      Atomically replaces *addr with val. An exception between the
+ *             exclusive load and store clears the monitor, so the store fails
+ *             and the swap is retried; the retry count is bounded by the
+ *             number of preemptions.
+ *
+ * @return     The previous value.
+ */
+static uint32_t atomic_swap( volatile uint32_t *addr, uint32_t val ) {
+  uint32_t old, failed;
+  do {
+    __asm volatile( "ldrex %0, [%1]" : "=r"( old ) : "r"( addr ) : "memory" );
+    __asm volatile( "strex %0, %2, [%1]" : "=&r"( failed ) : "r"( addr ), "r"( val ) : "memory" );
+  } while ( failed );
+  return old;
+}
+
+static inline void dmb( void ) {
+  __asm volatile( "dmb" ::: "memory" );
+}
+
+static inline uint8_t *slot( triple_buffer_t *tb, uint32_t index ) {
+  return tb->storage + index * tb->size;
+}
+
+int triple_buffer_init( triple_buffer_t *tb, void *storage, uint32_t size ) {
+  if ( tb == NULL || storage == NULL || size == 0 ) {
+    return -1;
+  }
+
+  tb->storage = ( uint8_t * )storage;
+  tb->size = size;
+  tb->back = 0;
+  tb->middle = 1;
+  tb->front = 2;
+  tb->front_valid = 0;
+
+  return 0;
+}
+
+void *triple_buffer_write_begin( triple_buffer_t *tb ) {
+  return slot( tb, tb->back );
+}
+
+void triple_buffer_commit( triple_buffer_t *tb ) {
+  /* The sample must be in memory before the reader can get to the slot */
+  dmb();
+  tb->back = atomic_swap( &tb->middle, tb->back | TB_FRESH ) & TB_INDEX;
+}
+
+void triple_buffer_publish( triple_buffer_t *tb, const void *value ) {
+  memcpy( triple_buffer_write_begin( tb ), value, tb->size );
+  triple_buffer_commit( tb );
+}
+
+const void *triple_buffer_read_begin( triple_buffer_t *tb, int *fresh ) {
+  int is_fresh = 0;
+
+  /* Only swap when there is something new, otherwise the reader would hand
+   * its own stale slot back as the hand-over slot and lose the sample. */
+  if ( tb->middle & TB_FRESH ) {
+    tb->front = atomic_swap( &tb->middle, tb->front ) & TB_INDEX;
+    tb->front_valid = 1;
+    is_fresh = 1;
+    dmb();
+  }
+
+  if ( fresh != NULL ) {
+    *fresh = is_fresh;
+  }
+
+  return tb->front_valid ? slot( tb, tb->front ) : NULL;
+}
+
+int triple_buffer_read( triple_buffer_t *tb, void *value ) {
+  int fresh;
+  const void *sample = triple_buffer_read_begin( tb, &fresh );
+
+  if ( sample == NULL ) {
+    return -1;
+  }
+
+  memcpy( value, sample, tb->size );
+  return fresh;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Benchmark of deferred logging against formatting on the target.
+ *
+ *         Times BATCH calls of DEFLOG() and of snprintf() with the same
+ *         format and arguments, ROUNDS times, and prints the average cost
+ *         per call in cycles of the 16MHz clock. snprintf() is what printf()
+ *         pays before a single byte reaches the UART.
+ *
+ *         Every batch fits in the log ring, and the thread waits for the
+ *         ring to drain between batches, so no record is dropped. The
+ *         records themselves only make sense through the host decoder:
+ *           make decoder
+ *           build/deflog_decode build/bin/<binary>.elf < /dev/ttyACM0
+ *
+ * @note   Prints:
+ * deflog   : <n> cycles/call
+ * snprintf : <n> cycles/call
+ * dropped  : 0
+ * and ROUNDS records "round <r>: ..." through the decoder.
+ */
+
+#include <349_lib.h>
+#include <349_threads.h>
+#include <deflog.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 1
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Calls timed back to back, 64 records of 12 bytes fit the ring */
+#define BATCH 64
+
+/** @brief Number of batches */
+#define ROUNDS 8
+
+/** @brief Cycles per microsecond of the 16MHz clock */
+#define CYCLES_PER_US 16
+
+/** @brief Ticks for the ring to drain between batches */
+#define DRAIN_TICKS 100
+
+/** @brief Logs, formats and prints the results */
+void bench_thread( UNUSED void *vargp ) {
+  static char line[64];
+  uint64_t deflog_us = 0;
+  uint64_t snprintf_us = 0;
+
+  for ( uint32_t r = 0; r < ROUNDS; r++ ) {
+    uint64_t start = get_time_us();
+    for ( uint32_t i = 0; i < BATCH; i++ ) {
+      DEFLOG( "sample %u value %d", i, -( int )i );
+    }
+    deflog_us += get_time_us() - start;
+
+    start = get_time_us();
+    for ( uint32_t i = 0; i < BATCH; i++ ) {
+      snprintf( line, sizeof( line ), "sample %u value %d", ( unsigned int )i, -( int )i );
+    }
+    snprintf_us += get_time_us() - start;
+
+    sleep_for( DRAIN_TICKS );
+    DEFLOG( "round %u: deflog %u us, snprintf %u us", r, ( uint32_t )deflog_us, ( uint32_t )snprintf_us );
+  }
+
+  sleep_for( DRAIN_TICKS );
+  printf( "\ndeflog   : %lu cycles/call\n",
+          ( unsigned long )( deflog_us * CYCLES_PER_US / ( ROUNDS * BATCH ) ) );
+  printf( "snprintf : %lu cycles/call\n",
+          ( unsigned long )( snprintf_us * CYCLES_PER_US / ( ROUNDS * BATCH ) ) );
+  printf( "dropped  : %lu\n", ( unsigned long )deflog_dropped );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( deflog_init() );
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  ABORT_ON_ERROR( thread_create( &bench_thread, 0, 500, 1000, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Benchmark of the lock-free ring buffers against the `%` indexed
+ *         Queue the UART driver used to have.
+ *
+ *         Each case pushes and pops BENCH_BYTES bytes through a 16-byte
+ *         buffer, one byte at a time and in BATCH sized chunks, and reports
+ *         the elapsed scheduler ticks. The legacy case keeps its PRIMASK
+ *         save/disable/restore around every enqueue and dequeue, like
+ *         uart_put_byte() and USART2_TX_IRQHandler() did. In user mode the
+ *         PRIMASK write is ignored but the instructions are still paid for.
+ *
+ * @note   Prints one line per case, lower is better:
+ * legacy queue          : <n> ticks
+ * spsc single byte      : <n> ticks
+ * spsc batch            : <n> ticks
+ * mpsc single byte      : <n> ticks
+ * mpsc batch            : <n> ticks
+ */
+
+#include <349_lib.h>
+#include <349_threads.h>
+#include <ring_buffer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 1
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Bytes moved through the buffer per case */
+#define BENCH_BYTES 200000
+/** @brief Buffer size, same as the old UART Queue */
+#define QUEUE_SIZE 16
+/** @brief Chunk size of the batch cases */
+#define BATCH 8
+
+/** @brief Copy of the legacy UART Queue */
+typedef struct Queue{
+  char array[QUEUE_SIZE];
+  uint32_t tail;
+  uint32_t header;
+  uint32_t count;
+} Queue;
+
+static int legacy_save_and_disable( void ) {
+  int result;
+  int disable_constant = 1;
+  __asm volatile( "mrs %0, PRIMASK" : "=r"( result ) );
+  __asm volatile( "msr PRIMASK, %0" : : "r"( disable_constant ) );
+  __asm volatile( "cpsid i" );
+  return result;
+}
+
+static void legacy_restore( int state ) {
+  __asm volatile( "msr PRIMASK, %0" : : "r"( state ) );
+}
+
+static int legacy_enqueue( char c, Queue *q ) {
+  int state = legacy_save_and_disable();
+  if ( q->count >= QUEUE_SIZE ) {
+    legacy_restore( state );
+    return -1;
+  }
+  q->count++;
+  q->array[q->header] = c;
+  q->header = ( q->header + 1 ) % QUEUE_SIZE;
+  legacy_restore( state );
+  return 0;
+}
+
+static int legacy_dequeue( char *c, Queue *q ) {
+  int state = legacy_save_and_disable();
+  if ( q->count == 0 ) {
+    legacy_restore( state );
+    return -1;
+  }
+  q->count--;
+  *c = q->array[q->tail];
+  q->tail = ( q->tail + 1 ) % QUEUE_SIZE;
+  legacy_restore( state );
+  return 0;
+}
+
+/** @brief Defeats dead code elimination of the popped bytes */
+volatile uint32_t sink;
+
+static uint32_t bench_legacy( void ) {
+  Queue q = { .tail = 0, .header = 0, .count = 0 };
+  char c;
+  uint32_t start = get_time();
+  for ( uint32_t i = 0; i < BENCH_BYTES; i++ ) {
+    legacy_enqueue( ( char )i, &q );
+    legacy_dequeue( &c, &q );
+    sink += c;
+  }
+  return get_time() - start;
+}
+
+static uint32_t bench_single( int mpsc ) {
+  static uint8_t data[QUEUE_SIZE];
+  ring_buffer_t rb;
+  uint8_t c;
+  ring_init( &rb, data, QUEUE_SIZE );
+  uint32_t start = get_time();
+  for ( uint32_t i = 0; i < BENCH_BYTES; i++ ) {
+    if ( mpsc ) {
+      ring_mpsc_push( &rb, ( uint8_t )i );
+    }
+    else {
+      ring_spsc_push( &rb, ( uint8_t )i );
+    }
+    ring_pop( &rb, &c );
+    sink += c;
+  }
+  return get_time() - start;
+}
+
+static uint32_t bench_batch( int mpsc ) {
+  static uint8_t data[QUEUE_SIZE];
+  uint8_t chunk[BATCH] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  uint8_t out[BATCH];
+  ring_buffer_t rb;
+  ring_init( &rb, data, QUEUE_SIZE );
+  uint32_t start = get_time();
+  for ( uint32_t i = 0; i < BENCH_BYTES; i += BATCH ) {
+    if ( mpsc ) {
+      ring_mpsc_push_batch( &rb, chunk, BATCH );
+    }
+    else {
+      ring_spsc_push_batch( &rb, chunk, BATCH );
+    }
+    ring_pop_batch( &rb, out, BATCH );
+    sink += out[0];
+  }
+  return get_time() - start;
+}
+
+void bench_thread( UNUSED void *vargp ) {
+  printf( "legacy queue          : %lu ticks\n", bench_legacy() );
+  printf( "spsc single byte      : %lu ticks\n", bench_single( 0 ) );
+  printf( "spsc batch            : %lu ticks\n", bench_batch( 0 ) );
+  printf( "mpsc single byte      : %lu ticks\n", bench_single( 1 ) );
+  printf( "mpsc batch            : %lu ticks\n", bench_batch( 1 ) );
+  exit( 0 );
+}
+
+int main( void ) {
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+  ABORT_ON_ERROR( thread_create( &bench_thread, 0, 1000, 1000, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return -1;
+}
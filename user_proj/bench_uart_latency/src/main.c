@@ -0,0 +1,112 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Benchmark of the console priority inversion: worst case write()
+ *         latency of the highest priority thread while a low priority
+ *         logger keeps the UART saturated.
+ *
+ *         Build it twice and compare:
+ *           make USER_PROJ=bench_uart_latency                       (bands)
+ *           make USER_PROJ=bench_uart_latency ARG=-DUART_TX_BANDS=1 (shared)
+ *
+ *         The logger queues LOG_BYTES every 10 ms, about twice what 115200
+ *         baud can carry, so with one shared ring it is always full and
+ *         the top thread has to wait until half of it went out. With
+ *         priority bands the top thread only waits for its own output.
+ *
+ * @note   Prints:
+ * samples         : <n>
+ * max write time  : <n> us
+ * avg write time  : <n> us
+ */
+
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Periods in ticks */
+//@{
+#define TOP_PERIOD 50
+#define LOG_PERIOD 10
+//@}
+
+/** @brief Bytes the logger queues per period, 20 KB/s */
+#define LOG_BYTES 200
+
+/** @brief Number of timed writes of the top thread */
+#define SAMPLES 100
+
+/** @brief Ticks the logger runs before the first sample */
+#define WARMUP 500
+
+volatile int done;
+static char log_line[LOG_BYTES];
+static char top_line[] = "top priority thread\n";
+
+/** @brief Saturates the UART until the top thread is done */
+void logger_thread( UNUSED void *vargp ) {
+  memset( log_line, 'L', sizeof( log_line ) );
+  log_line[LOG_BYTES - 1] = '\n';
+
+  while ( !done ) {
+    write( STDOUT_FILENO, log_line, LOG_BYTES );
+    wait_until_next_period();
+  }
+}
+
+/** @brief Times its own short writes and prints the results at the end
+ */
+void top_thread( UNUSED void *vargp ) {
+  uint64_t max = 0;
+  uint64_t total = 0;
+
+  while ( get_time() < WARMUP ) {
+    wait_until_next_period();
+  }
+
+  for ( int i = 0; i < SAMPLES; i++ ) {
+    uint64_t start = get_time_us();
+    write( STDOUT_FILENO, top_line, sizeof( top_line ) - 1 );
+    uint64_t elapsed = get_time_us() - start;
+
+    total += elapsed;
+    if ( elapsed > max ) {
+      max = elapsed;
+    }
+    wait_until_next_period();
+  }
+  done = 1;
+
+  printf( "\nsamples         : %d\n", SAMPLES );
+  printf( "max write time  : %lu us\n", ( unsigned long )max );
+  printf( "avg write time  : %lu us\n", ( unsigned long )( total / SAMPLES ) );
+}
+
+/** @brief Nothing to do while idle */
+void idle_thread( void ) {
+  while ( 1 ) {
+  }
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, &idle_thread, NUM_MUTEXES ) );
+
+  ABORT_ON_ERROR( thread_create( &top_thread, 0, 5, TOP_PERIOD, NULL ) );
+  ABORT_ON_ERROR( thread_create( &logger_thread, 1, 2, LOG_PERIOD, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
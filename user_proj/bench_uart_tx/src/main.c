@@ -0,0 +1,121 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Benchmark of the UART transmit path: DMA1 Stream6 against one
+ *         TXE interrupt per byte.
+ *
+ *         Build it twice and compare:
+ *           make USER_PROJ=bench_uart_tx                      (DMA)
+ *           make USER_PROJ=bench_uart_tx ARG=-DUART_TX_DMA=0  (per byte IRQ)
+ *
+ *         The idle function counts loop iterations, so the idle count over
+ *         a window measures the CPU nobody else used.
+ *           1. baseline: one second without output.
+ *           2. load: two seconds of LOAD_BYTES every 10 ms, close to line
+ *              rate but never more, so the writer never waits for space.
+ *              CPU load is the share of the baseline idle rate that was
+ *              lost, and covers the writer's copy plus the driver.
+ *           3. throughput: THROUGHPUT_BYTES in one write(). The last ring
+ *              full of bytes is still in flight when write() returns, so
+ *              this overestimates the rate by the same amount in both
+ *              builds.
+ *
+ * @note   Prints:
+ * idle baseline   : <n> loops/s
+ * idle under load : <n> loops/s
+ * cpu load        : <n>.<n> %
+ * throughput      : <n> bytes/s
+ */
+
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 1
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Writer period in ticks */
+#define PERIOD 10
+/** @brief Bytes written per period during the load phase, 10 KB/s */
+#define LOAD_BYTES 100
+/** @brief Bytes written back to back for the throughput phase */
+#define THROUGHPUT_BYTES 8192
+
+/** @brief Phase boundaries in ticks */
+//@{
+#define BASELINE_START 1000
+#define LOAD_START 2000
+#define LOAD_END 4000
+//@}
+
+volatile uint32_t idle_loops;
+static char block[THROUGHPUT_BYTES];
+
+/** @brief Counts spare CPU */
+void count_idle( void ) {
+  while ( 1 ) {
+    idle_loops++;
+  }
+}
+
+/** @brief Drives the phases and prints the results at the end
+ */
+void writer_thread( UNUSED void *vargp ) {
+  uint32_t base_start = 0;
+  uint32_t load_start = 0;
+  uint32_t load_end = 0;
+
+  memset( block, 'U', sizeof( block ) );
+  for ( uint32_t i = LOAD_BYTES - 1; i < sizeof( block ); i += LOAD_BYTES ) {
+    block[i] = '\n';
+  }
+
+  while ( get_time() < BASELINE_START ) {
+    wait_until_next_period();
+  }
+  base_start = idle_loops;
+
+  while ( get_time() < LOAD_START ) {
+    wait_until_next_period();
+  }
+  load_start = idle_loops;
+
+  while ( get_time() < LOAD_END ) {
+    write( STDOUT_FILENO, block, LOAD_BYTES );
+    wait_until_next_period();
+  }
+  load_end = idle_loops;
+
+  uint64_t start = get_time_us();
+  write( STDOUT_FILENO, block, THROUGHPUT_BYTES );
+  uint64_t elapsed = get_time_us() - start;
+
+  uint32_t base_rate = ( uint32_t )( ( uint64_t )( load_start - base_start ) * 1000 / ( LOAD_START - BASELINE_START ) );
+  uint32_t load_rate = ( uint32_t )( ( uint64_t )( load_end - load_start ) * 1000 / ( LOAD_END - LOAD_START ) );
+  uint32_t permille = base_rate ? 1000 - ( uint32_t )( ( uint64_t )load_rate * 1000 / base_rate ) : 0;
+
+  printf( "\nidle baseline   : %lu loops/s\n", ( unsigned long )base_rate );
+  printf( "idle under load : %lu loops/s\n", ( unsigned long )load_rate );
+  printf( "cpu load        : %lu.%lu %%\n", ( unsigned long )( permille / 10 ), ( unsigned long )( permille % 10 ) );
+  printf( "throughput      : %lu bytes/s\n",
+          ( unsigned long )( ( uint64_t )THROUGHPUT_BYTES * 1000000 / elapsed ) );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, &count_idle, NUM_MUTEXES ) );
+
+  ABORT_ON_ERROR( thread_create( &writer_thread, 0, PERIOD - 1, PERIOD, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
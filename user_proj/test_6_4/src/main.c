@@ -0,0 +1,165 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Compares the release jitter of a sensor thread publishing its
+ *         latest sample through an IPCP mutex against a triple buffer.
+ *
+ *         The sensor (T0, period 10) publishes one sample per period. The
+ *         controller (T1, period 50) reads the latest sample and takes 4 ticks
+ *         to process it. In the mutex phase it processes while holding the
+ *         lock, so the ceiling raises it above the sensor and the sensor's
+ *         publish is pushed back. In the triple buffer phase neither side
+ *         ever blocks, so the sensor always publishes at its release.
+ *
+ *         Jitter is the spread of (publish time - release time) of the
+ *         sensor over each phase, in ticks.
+ *
+ * Starting scheduler...
+ * mutex:         lateness min 0 max 4 jitter 4, control read 10 samples
+ * triple buffer: lateness min 0 max 0 jitter 0, control read 10 samples
+ *
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <triple_buffer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 1
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Sensor period */
+#define SENSOR_T 10
+/** @brief Controller period */
+#define CONTROL_T 50
+/** @brief Ticks the controller spends on each sample */
+#define CONTROL_WORK 4
+/** @brief Controller periods per phase */
+#define PHASE_PERIODS 10
+
+/** @brief Phases of the test */
+enum { PHASE_MUTEX, PHASE_TRIPLE, PHASE_DONE };
+
+/** @brief The sample the sensor publishes */
+typedef struct {
+  uint32_t seq;
+  uint32_t time;
+  int32_t reading[4];
+} sample_t;
+
+/** @brief Release jitter of the sensor during one phase */
+typedef struct {
+  uint32_t min;
+  uint32_t max;
+  uint32_t reads;
+} stats_t;
+
+volatile uint32_t phase = PHASE_MUTEX;
+stats_t stats[2] = { { SENSOR_T, 0, 0 }, { SENSOR_T, 0, 0 } };
+
+mutex_t *sample_mutex;
+sample_t shared_sample;
+
+triple_buffer_t channel;
+uint32_t channel_storage[TRIPLE_BUFFER_STORAGE( sizeof( sample_t ) ) / 4];
+
+static void record( stats_t *s, uint32_t lateness ) {
+  if ( lateness < s->min ) s->min = lateness;
+  if ( lateness > s->max ) s->max = lateness;
+}
+
+/** @brief Sensor thread, publishes a new sample every period
+ *  T0 (2, 10)
+ */
+void sensor_thread( UNUSED void *vargp ) {
+  sample_t sample = { 0 };
+
+  while ( phase != PHASE_DONE ) {
+    uint32_t p = phase;
+    sample.seq++;
+    sample.reading[sample.seq % 4] = sample.seq * 3;
+
+    if ( p == PHASE_MUTEX ) {
+      mutex_lock( sample_mutex );
+      sample.time = get_time();
+      shared_sample = sample;
+      mutex_unlock( sample_mutex );
+    }
+    else {
+      sample.time = get_time();
+      triple_buffer_publish( &channel, &sample );
+    }
+
+    /* Releases happen at multiples of the period */
+    record( &stats[p], sample.time % SENSOR_T );
+
+    wait_until_next_period();
+  }
+}
+
+/** @brief Controller thread, processes the latest sample every period
+ *  T1 (10, 50)
+ */
+void control_thread( UNUSED void *vargp ) {
+  sample_t sample;
+  uint32_t cnt = 0;
+
+  while ( 1 ) {
+    if ( phase == PHASE_MUTEX ) {
+      mutex_lock( sample_mutex );
+      sample = shared_sample;
+      spin_wait( CONTROL_WORK );
+      mutex_unlock( sample_mutex );
+      stats[PHASE_MUTEX].reads++;
+    }
+    else {
+      if ( triple_buffer_read( &channel, &sample ) >= 0 ) {
+        stats[PHASE_TRIPLE].reads++;
+      }
+      spin_wait( CONTROL_WORK );
+    }
+
+    cnt++;
+    if ( cnt == PHASE_PERIODS ) {
+      phase = PHASE_TRIPLE;
+    }
+    else if ( cnt == 2 * PHASE_PERIODS ) {
+      break;
+    }
+
+    wait_until_next_period();
+  }
+
+  phase = PHASE_DONE;
+
+  printf( "mutex:         lateness min %lu max %lu jitter %lu, control read %lu samples\n",
+          stats[0].min, stats[0].max, stats[0].max - stats[0].min, stats[0].reads );
+  printf( "triple buffer: lateness min %lu max %lu jitter %lu, control read %lu samples\n",
+          stats[1].min, stats[1].max, stats[1].max - stats[1].min, stats[1].reads );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  sample_mutex = mutex_init( 0 );
+  if ( sample_mutex == NULL ) {
+    printf( "Failed to create mutex\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( triple_buffer_init( &channel, channel_storage, sizeof( sample_t ) ) );
+
+  ABORT_ON_ERROR( thread_create( &sensor_thread, 0, 2, SENSOR_T, NULL ) );
+  ABORT_ON_ERROR( thread_create( &control_thread, 1, 10, CONTROL_T, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
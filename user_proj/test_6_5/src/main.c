@@ -0,0 +1,159 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Reader-writer lock with read and write ceilings.
+ *
+ * T0: reader (10, 100), T1: reader (20, 200), T2: writer (20, 1000)
+ * read ceiling 2 (only T2 writes), write ceiling 0
+ *
+ * The readers keep their own priority inside the read section, so T0 can
+ * preempt T1 while T1 reads. The writer runs at the write ceiling.
+ *
+ * T3: holder (10, 1000), T4: timed writer (10, 1000), T5: late reader
+ * (10, 1000) use a second lock, read ceiling 4, write ceiling 3
+ *
+ * T3 reads the second lock from t=30 to t=50. T4 asks to write at t=32
+ * with a 5 tick timeout and T5 asks to read at t=34, behind the waiting
+ * writer. When T4 gives up at t=37 the lock is readable again, so T5 must
+ * get it right away instead of when T3 unlocks.
+ *
+ * Expected output: the readers report their own priority (0 and 1) in
+ * the read section where a mutex would have raised both to 0, the writer
+ * reports priority 0, and Cnt is the configuration version the reader saw.
+ * t=0	Thread reader	Prio: 0	Cnt: 0
+ * t=5	Thread reader	Prio: 1	Cnt: 0
+ * t=15	Thread writer	Prio: 0	Cnt: 1
+ * t=37	Thread late reader	Prio: 4
+ * t=37	Thread writer timed out
+ * t=100	Thread reader	Prio: 0	Cnt: 1
+ * ...
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 6
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief How much to reduce spin wait */
+#define REDUCE_SPIN_MS 2
+
+/** @brief Periods the writer runs for */
+#define WRITER_PERIODS 2
+
+/** @brief Timeline of the timed writer case on the second lock */
+//@{
+#define HOLD_START 30
+#define HOLD_END 50
+#define WRITE_TIME 32
+#define WRITE_TIMEOUT 5
+#define LATE_READ_TIME 34
+//@}
+
+rwlock_t *config_lock;
+volatile uint32_t config_version;
+rwlock_t *timed_lock;
+
+/** @brief Reader, takes the read lock every period and reports its priority
+ */
+void reader_thread( void *vargp ) {
+  uint32_t work = ( uint32_t )vargp;
+  int cnt = 0;
+
+  while ( cnt < 20 ) {
+    ABORT_ON_ERROR( rwlock_read_lock( config_lock, WAIT_FOREVER ) );
+    print_status_prio_cnt( "reader", config_version );
+    spin_wait( work - REDUCE_SPIN_MS );
+    rwlock_unlock( config_lock );
+    cnt++;
+    wait_until_next_period();
+  }
+}
+
+/** @brief Writer, updates the configuration once per period
+ */
+void writer_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < WRITER_PERIODS; cnt++ ) {
+    ABORT_ON_ERROR( rwlock_write_lock( config_lock, WAIT_FOREVER ) );
+    config_version++;
+    print_status_prio_cnt( "writer", config_version );
+    spin_wait( 10 - REDUCE_SPIN_MS );
+    rwlock_unlock( config_lock );
+    wait_until_next_period();
+  }
+}
+
+/** @brief Holds the second lock for reading while the others queue up
+ */
+void holder_thread( UNUSED void *vargp ) {
+  sleep_until( HOLD_START );
+  ABORT_ON_ERROR( rwlock_read_lock( timed_lock, WAIT_FOREVER ) );
+  sleep_until( HOLD_END );
+  rwlock_unlock( timed_lock );
+}
+
+/** @brief Gives up on writing while a reader waits behind it
+ */
+void timed_writer_thread( UNUSED void *vargp ) {
+  sleep_until( WRITE_TIME );
+  int err = rwlock_write_lock( timed_lock, WRITE_TIMEOUT );
+  if ( err != ERR_TIMEOUT ) {
+    printf( "Test failed: timed write lock returned %d\n", err );
+    if ( err == 0 ) {
+      rwlock_unlock( timed_lock );
+    }
+    return;
+  }
+  print_status( "writer timed out" );
+}
+
+/** @brief Reads the second lock, queued behind the timed writer
+ */
+void late_reader_thread( UNUSED void *vargp ) {
+  sleep_until( LATE_READ_TIME );
+  ABORT_ON_ERROR( rwlock_read_lock( timed_lock, WAIT_FOREVER ) );
+  if ( get_time() >= HOLD_END ) {
+    printf( "Test failed: reader only admitted when the holder unlocked\n" );
+  }
+  print_status_prio( "late reader" );
+  rwlock_unlock( timed_lock );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  config_lock = rwlock_init( 2, 0 );
+  if ( config_lock == NULL ) {
+    printf( "Failed to create rwlock\n" );
+    return -1;
+  }
+
+  timed_lock = rwlock_init( 4, 3 );
+  if ( timed_lock == NULL ) {
+    printf( "Failed to create rwlock\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( rwlock_declare( config_lock, 0, 5, 0 ) );
+  ABORT_ON_ERROR( rwlock_declare( config_lock, 1, 10, 0 ) );
+  ABORT_ON_ERROR( rwlock_declare( config_lock, 2, 0, 10 ) );
+
+  ABORT_ON_ERROR( thread_create( &reader_thread, 0, 10, 100, ( void * )5 ) );
+  ABORT_ON_ERROR( thread_create( &reader_thread, 1, 20, 200, ( void * )10 ) );
+  ABORT_ON_ERROR( thread_create( &writer_thread, 2, 20, 1000, NULL ) );
+  ABORT_ON_ERROR( thread_create( &holder_thread, 3, 10, 1000, NULL ) );
+  ABORT_ON_ERROR( thread_create( &timed_writer_thread, 4, 10, 1000, NULL ) );
+  ABORT_ON_ERROR( thread_create( &late_reader_thread, 5, 10, 1000, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
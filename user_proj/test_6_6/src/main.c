@@ -0,0 +1,95 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Condition variable bound to an IPCP mutex.
+ *
+ * T0: consumer (10, 100), T1: producer (10, 300)
+ * mutex ceiling 0
+ *
+ * The consumer waits for items under the mutex. Its wait drops the mutex,
+ * so the producer can lock it and signal. The consumer then holds the
+ * mutex again when cond_wait() returns.
+ *
+ * Expected output: the consumer waits at its own priority, the producer
+ * runs at the ceiling, and the consumer takes one item in each of its periods.
+ * t=0	Thread consumer	Prio: 0	Cnt: 0
+ * t=0	Thread producer	Prio: 0	Cnt: 3
+ * t=0	Thread consumer	Prio: 0	Cnt: 2
+ * t=100	Thread consumer	Prio: 0	Cnt: 1
+ * t=200	Thread consumer	Prio: 0	Cnt: 0
+ * t=300	Thread consumer	Prio: 0	Cnt: 0
+ * t=300	Thread producer	Prio: 0	Cnt: 3
+ * ...
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 1
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Items the producer adds each period */
+#define BATCH 3
+
+mutex_t *items_lock;
+cond_t *items_ready;
+volatile uint32_t items;
+
+/** @brief Consumer, takes one item per period and waits while none are left
+ */
+void consumer_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < 9; cnt++ ) {
+    mutex_lock( items_lock );
+    while ( items == 0 ) {
+      print_status_prio_cnt( "consumer", items );
+      ABORT_ON_ERROR( cond_wait( items_ready, WAIT_FOREVER ) );
+    }
+    items--;
+    print_status_prio_cnt( "consumer", items );
+    mutex_unlock( items_lock );
+    wait_until_next_period();
+  }
+}
+
+/** @brief Producer, refills the items and signals the consumer
+ */
+void producer_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < 3; cnt++ ) {
+    mutex_lock( items_lock );
+    items += BATCH;
+    print_status_prio_cnt( "producer", items );
+    cond_signal( items_ready );
+    mutex_unlock( items_lock );
+    wait_until_next_period();
+  }
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  items_lock = mutex_init( 0 );
+  if ( items_lock == NULL ) {
+    printf( "Failed to create mutex\n" );
+    return -1;
+  }
+  items_ready = cond_init( items_lock );
+  if ( items_ready == NULL ) {
+    printf( "Failed to create condition variable\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( thread_create( &consumer_thread, 0, 10, 100, NULL ) );
+  ABORT_ON_ERROR( thread_create( &producer_thread, 1, 10, 300, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Semaphore and event group waiters are woken by priority.
+ *
+ * T0, T1, T2: waiters (10, 200), T3: poster (10, 200)
+ *
+ * The waiters block lowest priority first: T2 at t=0, T1 at t=2, T0 at
+ * t=4. The poster then posts one unit at a time, and each post must wake
+ * the highest priority waiter left, so the units go to T0, T1, T2 in that
+ * order. The same is checked for an event group: the waiters block on flag
+ * 0x1 with EVENT_CLEAR in the same order, and every event_set() hands the
+ * flag to one waiter only, highest priority first.
+ *
+ * Expected output:
+ * Starting scheduler...
+ * t=10	Thread semaphore	Cnt: 0
+ * t=10	Thread semaphore	Cnt: 1
+ * t=10	Thread semaphore	Cnt: 2
+ * t=30	Thread event	Cnt: 0
+ * t=30	Thread event	Cnt: 1
+ * t=30	Thread event	Cnt: 2
+ * Test passed
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 4
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Number of waiting threads */
+#define NUM_WAITERS 3
+/** @brief Ticks between two waiters blocking */
+#define WAIT_GAP 2
+/** @brief When the poster posts the semaphore units */
+#define SEM_POST_TIME 10
+/** @brief When the waiters start blocking on the event group */
+#define EVENT_WAIT_TIME 20
+/** @brief When the poster sets the event flags */
+#define EVENT_SET_TIME 30
+/** @brief The flag the waiters consume */
+#define FLAG 0x1
+
+semaphore_t *sem;
+event_t *event;
+
+/** @brief Waiters in the order they were woken */
+volatile uint32_t sem_order[NUM_WAITERS];
+volatile uint32_t sem_woken;
+volatile uint32_t event_order[NUM_WAITERS];
+volatile uint32_t event_woken;
+
+/** @brief Blocks on the semaphore, then on the event group, lowest
+ *         priority first both times
+ */
+void waiter( void *vargp ) {
+  uint32_t id = ( uint32_t )vargp;
+
+  sleep_until( ( NUM_WAITERS - 1 - id ) * WAIT_GAP );
+  if ( semaphore_wait( sem ) < 0 ) {
+    printf( "Test failed: semaphore_wait in T%u\n", ( unsigned int )id );
+    return;
+  }
+  sem_order[sem_woken++] = id;
+  print_status_cnt( "semaphore", id );
+
+  sleep_until( EVENT_WAIT_TIME + ( NUM_WAITERS - 1 - id ) * WAIT_GAP );
+  uint32_t flags = 0;
+  if ( event_wait( event, FLAG, EVENT_WAIT_ANY | EVENT_CLEAR, &flags ) < 0 || flags != FLAG ) {
+    printf( "Test failed: event_wait in T%u\n", ( unsigned int )id );
+    return;
+  }
+  event_order[event_woken++] = id;
+  print_status_cnt( "event", id );
+}
+
+/** @brief Hands out one unit or flag at a time once every waiter blocks
+ */
+void poster( UNUSED void *vargp ) {
+  int failed = 0;
+
+  sleep_until( SEM_POST_TIME );
+  for ( int i = 0; i < NUM_WAITERS; i++ ) {
+    if ( semaphore_post( sem ) < 0 ) {
+      printf( "Test failed: semaphore_post %d\n", i );
+      failed = 1;
+    }
+  }
+
+  sleep_until( EVENT_SET_TIME );
+  for ( int i = 0; i < NUM_WAITERS; i++ ) {
+    /* the woken waiter consumes the flag, so none stays set */
+    if ( event_set( event, FLAG ) != 0 ) {
+      printf( "Test failed: flag still set after event_set %d\n", i );
+      failed = 1;
+    }
+  }
+
+  if ( sem_woken != NUM_WAITERS || event_woken != NUM_WAITERS ) {
+    printf( "Test failed: %u semaphore and %u event waiters woken\n",
+            ( unsigned int )sem_woken, ( unsigned int )event_woken );
+    return;
+  }
+  for ( uint32_t i = 0; i < NUM_WAITERS; i++ ) {
+    if ( sem_order[i] != i || event_order[i] != i ) {
+      printf( "Test failed: woken out of priority order\n" );
+      failed = 1;
+      break;
+    }
+  }
+  if ( !failed ) {
+    printf( "Test passed\n" );
+  }
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  sem = semaphore_init( 0, NUM_WAITERS );
+  if ( sem == NULL ) {
+    printf( "Failed to create semaphore\n" );
+    return -1;
+  }
+
+  event = event_init();
+  if ( event == NULL ) {
+    printf( "Failed to create event group\n" );
+    return -1;
+  }
+
+  for ( uint32_t i = 0; i < NUM_WAITERS; i++ ) {
+    ABORT_ON_ERROR( thread_create( &waiter, i, 10, 200, ( void * )i ) );
+  }
+  ABORT_ON_ERROR( thread_create( &poster, NUM_WAITERS, 10, 200, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
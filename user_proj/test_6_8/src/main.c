@@ -0,0 +1,189 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Message queue round trip.
+ *
+ * T0: consumer (10, 200), T1: producer (10, 200)
+ * 4 blocks of 32 bytes
+ *
+ * First the consumer waits for every message, so each commit hands the
+ * block straight to it. Then the producer fills the whole queue while the
+ * consumer sleeps, and a reserve that may not wait returns ERR_TIMEOUT.
+ * The consumer drains the queue in order and a receive on the empty queue
+ * returns ERR_TIMEOUT as well. Every message is checked in place, in a
+ * block of the buffer given to msgq_init(), and the high-water mark must
+ * reach the size of the queue.
+ *
+ * Expected output:
+ * Starting scheduler...
+ * t=0	Thread handed over	Cnt: 4
+ * t=10	Thread queue full	Cnt: 4
+ * t=20	Thread drained	Cnt: 4
+ * Test passed
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Blocks in the queue */
+#define NUM_BLOCKS 4
+/** @brief Payload words of a message */
+#define PAYLOAD_WORDS 7
+/** @brief When the producer fills the queue */
+#define FILL_TIME 10
+/** @brief When the consumer drains it */
+#define DRAIN_TIME 20
+
+/** @brief One message, filled and read in place */
+typedef struct {
+  uint32_t seq;
+  uint32_t payload[PAYLOAD_WORDS];
+} msg_t;
+
+/** @brief Storage of the queue */
+msg_t blocks[NUM_BLOCKS];
+
+msgq_t *queue;
+
+/** @brief Set by a thread that saw something wrong */
+volatile int failed;
+
+/** @brief Fills a message so that the consumer can check every word
+ */
+void fill( msg_t *msg, uint32_t seq ) {
+  msg->seq = seq;
+  for ( uint32_t i = 0; i < PAYLOAD_WORDS; i++ ) {
+    msg->payload[i] = seq * 31 + i;
+  }
+}
+
+/** @brief Checks a received message in place and gives its block back
+ *
+ *  @return 0 if it is the expected message, -1 otherwise
+ */
+int check_and_release( void *block, uint32_t seq ) {
+  msg_t *msg = ( msg_t * )block;
+  int err = 0;
+
+  if ( msg < &blocks[0] || msg >= &blocks[NUM_BLOCKS] ) {
+    printf( "Test failed: message %u not in the queue's buffer\n", ( unsigned int )seq );
+    return -1;
+  }
+  if ( msg->seq != seq ) {
+    printf( "Test failed: got message %u, expected %u\n",
+            ( unsigned int )msg->seq, ( unsigned int )seq );
+    err = -1;
+  }
+  for ( uint32_t i = 0; i < PAYLOAD_WORDS; i++ ) {
+    if ( msg->payload[i] != seq * 31 + i ) {
+      printf( "Test failed: message %u corrupted\n", ( unsigned int )seq );
+      err = -1;
+      break;
+    }
+  }
+  if ( msgq_release( queue, block ) < 0 ) {
+    printf( "Test failed: msgq_release of message %u\n", ( unsigned int )seq );
+    err = -1;
+  }
+  return err;
+}
+
+/** @brief Receives every message, first as they come, then all at once
+ */
+void consumer( UNUSED void *vargp ) {
+  void *block;
+  uint32_t seq = 0;
+
+  for ( int i = 0; i < NUM_BLOCKS; i++, seq++ ) {
+    if ( msgq_receive( queue, &block, WAIT_FOREVER ) < 0
+         || check_and_release( block, seq ) < 0 ) {
+      failed = 1;
+      return;
+    }
+  }
+  print_status_cnt( "handed over", NUM_BLOCKS );
+
+  sleep_until( DRAIN_TIME );
+  for ( int i = 0; i < NUM_BLOCKS; i++, seq++ ) {
+    if ( msgq_receive( queue, &block, 0 ) < 0 || check_and_release( block, seq ) < 0 ) {
+      failed = 1;
+      return;
+    }
+  }
+  print_status_cnt( "drained", NUM_BLOCKS );
+
+  int err = msgq_receive( queue, &block, 0 );
+  if ( err != ERR_TIMEOUT ) {
+    printf( "Test failed: receive on an empty queue returned %d\n", err );
+    failed = 1;
+    return;
+  }
+  if ( msgq_high_water( queue ) != NUM_BLOCKS ) {
+    printf( "Test failed: high-water mark %u\n", ( unsigned int )msgq_high_water( queue ) );
+    failed = 1;
+    return;
+  }
+  if ( !failed ) {
+    printf( "Test passed\n" );
+  }
+}
+
+/** @brief Sends every message, then fills the queue up
+ */
+void producer( UNUSED void *vargp ) {
+  void *block;
+  uint32_t seq = 0;
+
+  for ( int i = 0; i < NUM_BLOCKS * 2; i++, seq++ ) {
+    if ( i == NUM_BLOCKS ) {
+      sleep_until( FILL_TIME );
+    }
+    if ( msgq_reserve( queue, &block, WAIT_FOREVER ) < 0 ) {
+      printf( "Test failed: msgq_reserve of message %u\n", ( unsigned int )seq );
+      failed = 1;
+      return;
+    }
+    fill( ( msg_t * )block, seq );
+    if ( msgq_commit( queue, block ) < 0 ) {
+      printf( "Test failed: msgq_commit of message %u\n", ( unsigned int )seq );
+      failed = 1;
+      return;
+    }
+  }
+
+  int err = msgq_reserve( queue, &block, 0 );
+  if ( err != ERR_TIMEOUT ) {
+    printf( "Test failed: reserve on a full queue returned %d\n", err );
+    failed = 1;
+    return;
+  }
+  print_status_cnt( "queue full", NUM_BLOCKS );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  queue = msgq_init( blocks, sizeof( msg_t ), NUM_BLOCKS );
+  if ( queue == NULL ) {
+    printf( "Failed to create message queue\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( thread_create( &consumer, 0, 10, 200, NULL ) );
+  ABORT_ON_ERROR( thread_create( &producer, 1, 10, 200, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
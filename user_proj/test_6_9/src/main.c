@@ -0,0 +1,171 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Timed mutex lock, semaphore wait and event wait.
+ *
+ * T0: waiter (10, 200), T1: holder (10, 200)
+ * mutex ceiling 0
+ *
+ * For each object T0 first waits with a timeout that runs out before T1
+ * lets go, which must return ERR_TIMEOUT after exactly TIMEOUT ticks. It
+ * then waits again with a long timeout and must get the object as soon as
+ * T1 releases it. A zero timeout polls and returns ERR_TIMEOUT at once.
+ * The counts are the ticks each timed out wait took.
+ *
+ * Expected output:
+ * Starting scheduler...
+ * t=10	Thread mutex timeout	Cnt: 5
+ * t=20	Thread mutex locked
+ * t=25	Thread semaphore timeout	Cnt: 5
+ * t=30	Thread semaphore taken
+ * t=35	Thread event timeout	Cnt: 5
+ * t=40	Thread event received
+ * Test passed
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 1
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Timeout of the waits that must expire */
+#define TIMEOUT 5
+/** @brief Timeout of the waits that must succeed */
+#define LONG_TIMEOUT 50
+/** @brief When T0 starts waiting for the mutex */
+#define MUTEX_WAIT_TIME 5
+/** @brief When T1 unlocks the mutex, posts the semaphore, sets the flag */
+#define UNLOCK_TIME 20
+#define POST_TIME 30
+#define SET_TIME 40
+/** @brief The flag T0 waits for */
+#define FLAG 0x1
+
+mutex_t *mutex;
+semaphore_t *sem;
+event_t *event;
+
+/** @brief Checks that a wait timed out after TIMEOUT ticks
+ *
+ *  @return 0 if it did, -1 otherwise
+ */
+int check_timeout( char *name, int err, uint32_t start ) {
+  uint32_t waited = get_time() - start;
+
+  if ( err != ERR_TIMEOUT ) {
+    printf( "Test failed: %s returned %d instead of ERR_TIMEOUT\n", name, err );
+    return -1;
+  }
+  if ( waited < TIMEOUT || waited > TIMEOUT + 1 ) {
+    printf( "Test failed: %s timed out after %u ticks\n", name, ( unsigned int )waited );
+    return -1;
+  }
+  print_status_cnt( name, waited );
+  return 0;
+}
+
+/** @brief Times out on every object once, then gets it
+ */
+void waiter( UNUSED void *vargp ) {
+  uint32_t start;
+  int err;
+
+  sleep_until( MUTEX_WAIT_TIME );
+  start = get_time();
+  err = mutex_lock_timed( mutex, TIMEOUT );
+  if ( check_timeout( "mutex timeout", err, start ) < 0 ) {
+    return;
+  }
+  if ( mutex_lock_timed( mutex, LONG_TIMEOUT ) != 0 ) {
+    printf( "Test failed: mutex not handed over\n" );
+    return;
+  }
+  print_status( "mutex locked" );
+  mutex_unlock( mutex );
+
+  if ( semaphore_wait_timed( sem, 0 ) != ERR_TIMEOUT ) {
+    printf( "Test failed: polling an empty semaphore did not time out\n" );
+    return;
+  }
+  start = get_time();
+  err = semaphore_wait_timed( sem, TIMEOUT );
+  if ( check_timeout( "semaphore timeout", err, start ) < 0 ) {
+    return;
+  }
+  if ( semaphore_wait_timed( sem, LONG_TIMEOUT ) != 0 ) {
+    printf( "Test failed: semaphore unit not received\n" );
+    return;
+  }
+  print_status( "semaphore taken" );
+
+  uint32_t flags = 0;
+  if ( event_wait_timed( event, FLAG, EVENT_WAIT_ANY, &flags, 0 ) != ERR_TIMEOUT ) {
+    printf( "Test failed: polling a clear flag did not time out\n" );
+    return;
+  }
+  start = get_time();
+  err = event_wait_timed( event, FLAG, EVENT_WAIT_ANY | EVENT_CLEAR, &flags, TIMEOUT );
+  if ( check_timeout( "event timeout", err, start ) < 0 ) {
+    return;
+  }
+  if ( event_wait_timed( event, FLAG, EVENT_WAIT_ANY | EVENT_CLEAR, &flags, LONG_TIMEOUT ) != 0
+       || flags != FLAG ) {
+    printf( "Test failed: event flag not received\n" );
+    return;
+  }
+  print_status( "event received" );
+
+  printf( "Test passed\n" );
+}
+
+/** @brief Holds the mutex, then releases each object in turn
+ */
+void holder( UNUSED void *vargp ) {
+  mutex_lock( mutex );
+  sleep_until( UNLOCK_TIME );
+  mutex_unlock( mutex );
+
+  sleep_until( POST_TIME );
+  semaphore_post( sem );
+
+  sleep_until( SET_TIME );
+  event_set( event, FLAG );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  mutex = mutex_init( 0 );
+  if ( mutex == NULL ) {
+    printf( "Failed to create mutex\n" );
+    return -1;
+  }
+
+  sem = semaphore_init( 0, 1 );
+  if ( sem == NULL ) {
+    printf( "Failed to create semaphore\n" );
+    return -1;
+  }
+
+  event = event_init();
+  if ( event == NULL ) {
+    printf( "Failed to create event group\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( thread_create( &waiter, 0, 10, 200, NULL ) );
+  ABORT_ON_ERROR( thread_create( &holder, 1, 10, 200, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
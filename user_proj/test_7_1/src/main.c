@@ -0,0 +1,88 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Two stage pipeline synchronized with a phase counter, plus a
+ *         barrier that lines both stages up at the start of a frame.
+ *
+ * T0: consumer (10, 100), T1: producer (20, 100)
+ *
+ * The consumer has the higher priority but must not run a frame before the
+ * producer finished it. phase_wait() with RENDEZVOUS_NEXT_PERIOD replaces
+ * wait_until_next_period(): the consumer is released at the later of its
+ * next period and the producer signalling the frame.
+ *
+ * Expected output: every frame the consumer prints right after the producer
+ * and both report the same Cnt.
+ * t=0	Thread producer	Prio: 1	Cnt: 0
+ * t=20	Thread consumer	Prio: 0	Cnt: 0
+ * t=100	Thread producer	Prio: 1	Cnt: 1
+ * t=120	Thread consumer	Prio: 0	Cnt: 1
+ * ...
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief How much to reduce spin wait */
+#define REDUCE_SPIN_MS 2
+
+/** @brief Frames the pipeline runs for */
+#define FRAMES 10
+
+barrier_t *start_barrier;
+phase_t *frame_done;
+
+/** @brief First stage, produces one frame per period
+ */
+void producer_thread( UNUSED void *vargp ) {
+  barrier_wait( start_barrier, 0 );
+
+  for ( uint32_t cnt = 0; cnt < FRAMES; cnt++ ) {
+    print_status_prio_cnt( "producer", cnt );
+    spin_wait( 20 - REDUCE_SPIN_MS );
+    phase_signal( frame_done );
+    wait_until_next_period();
+  }
+}
+
+/** @brief Second stage, consumes each frame once the producer is done
+ */
+void consumer_thread( UNUSED void *vargp ) {
+  barrier_wait( start_barrier, 0 );
+
+  ABORT_ON_ERROR( phase_wait( frame_done, 1, 0 ) );
+  for ( uint32_t cnt = 0; cnt < FRAMES; cnt++ ) {
+    print_status_prio_cnt( "consumer", cnt );
+    spin_wait( 10 - REDUCE_SPIN_MS );
+    ABORT_ON_ERROR( phase_wait( frame_done, cnt + 2, RENDEZVOUS_NEXT_PERIOD ) );
+  }
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  start_barrier = barrier_init( NUM_THREADS );
+  frame_done = phase_init();
+  if ( start_barrier == NULL || frame_done == NULL ) {
+    printf( "Failed to create rendezvous\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( thread_create( &producer_thread, 1, 20, 100, NULL ) );
+  ABORT_ON_ERROR( thread_create( &consumer_thread, 0, 10, 100, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
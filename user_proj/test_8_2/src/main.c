@@ -0,0 +1,95 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Blocking-aware admission and critical section overrun check.
+ *
+ * T0: (20, 100),  S(0-5)
+ * T1: (30, 150),  S(0-5)
+ * T2: (100, 400), S(0-50), overruns to 60 on its last period
+ *
+ * With B_0 = B_1 = 50 the set passes the UB test with blocking. Raising
+ * T2's declared section to 80 makes B_1/T_1 too large for T1 and the
+ * declaration is rejected. On T2's last period the kernel prints a
+ * warning that mutex 0 was held for longer than declared.
+ *
+ * Expected output:
+ * Declaring 80 ticks rejected
+ * Starting scheduler...
+ * ...
+ * Warning: Thread 2 held mutex 0 for 6x ticks, declared 50
+ */
+
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 3
+#define NUM_MUTEXES 1
+#define CLOCK_FREQUENCY 1000
+
+/** @brief How much to reduce spin wait */
+#define REDUCE_SPIN_MS 2
+
+/** @brief Periods each thread runs for */
+#define NUM_PERIODS 3
+
+mutex_t *mutex_0;
+
+/** @brief T0 and T1 take the mutex for a short section every period
+ */
+void short_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < NUM_PERIODS; cnt++ ) {
+    mutex_lock( mutex_0 );
+    spin_wait( 5 - REDUCE_SPIN_MS );
+    mutex_unlock( mutex_0 );
+    print_status_prio( "short" );
+    wait_until_next_period();
+  }
+}
+
+/** @brief T2 holds the mutex for its declared 50 ticks, then overruns
+ */
+void long_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < NUM_PERIODS; cnt++ ) {
+    mutex_lock( mutex_0 );
+    spin_wait( cnt == NUM_PERIODS - 1 ? 60 : 50 - REDUCE_SPIN_MS );
+    mutex_unlock( mutex_0 );
+    print_status_prio( "long" );
+    wait_until_next_period();
+  }
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  mutex_0 = mutex_init( 0 );
+  if ( mutex_0 == NULL ) {
+    printf( "Failed to create mutex 0\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( mutex_declare( mutex_0, 0, 5 ) );
+  ABORT_ON_ERROR( mutex_declare( mutex_0, 1, 5 ) );
+  ABORT_ON_ERROR( mutex_declare( mutex_0, 2, 50 ) );
+
+  ABORT_ON_ERROR( thread_create( &short_thread, 0, 20, 100, NULL ) );
+  ABORT_ON_ERROR( thread_create( &short_thread, 1, 30, 150, NULL ) );
+  ABORT_ON_ERROR( thread_create( &long_thread, 2, 100, 400, NULL ) );
+
+  if ( mutex_declare( mutex_0, 2, 80 ) == 0 ) {
+    printf( "Declaring 80 ticks should have been rejected\n" );
+    return -1;
+  }
+  printf( "Declaring 80 ticks rejected\n" );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
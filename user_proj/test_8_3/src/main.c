@@ -0,0 +1,114 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Two-mutex deadlock is reported as ERR_DEADLOCK.
+ *
+ * T0: (20, 100), T1: (30, 200)
+ * mutex ceilings 0
+ *
+ * T1 locks M0 and sleeps, T0 wakes up and waits for M0. T1 then locks M1
+ * and hands M0 over to T0 by unlocking it, so each thread holds one mutex.
+ * T1 waits for M0 and T0 asks for M1, which would close the cycle
+ * T0 -> M1 -> T1 -> M0 -> T0. With the default DEADLOCK_FAIL_LOCK the
+ * kernel prints the cycle and T0's lock fails. T0 backs off by unlocking
+ * M0, and T1 gets it.
+ *
+ * Expected output:
+ * Starting scheduler...
+ * t=0	Thread 1, 0 locked
+ * t=10	Thread 1, 1 locked
+ * t=10	Thread 0, 0 locked
+ * Deadlock: thread 0 -> mutex 1 -> thread 1 -> mutex 0 -> thread 0, lock failed
+ * t=10	Thread 0, ERR_DEADLOCK
+ * t=10	Thread 1, 0 locked again
+ * Test passed
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 2
+#define CLOCK_FREQUENCY 1000
+
+mutex_t *mutex_0;
+mutex_t *mutex_1;
+
+/** @brief T0 waits for M0 while T1 holds it, then asks for M1
+ */
+void thread_0( UNUSED void *vargp ) {
+  /* let T1 take M0 first */
+  sleep_for( 5 );
+
+  mutex_lock( mutex_0 );
+  print_status( "0, 0 locked" );
+
+  int err = mutex_lock_timed( mutex_1, WAIT_FOREVER );
+  if ( err != ERR_DEADLOCK ) {
+    printf( "Test failed: T0 got %d instead of ERR_DEADLOCK\n", err );
+    if ( err == 0 ) {
+      mutex_unlock( mutex_1 );
+    }
+  }
+  else {
+    print_status( "0, ERR_DEADLOCK" );
+  }
+
+  mutex_unlock( mutex_0 );
+}
+
+/** @brief T1 hands M0 to T0 while holding M1, then wants M0 back
+ */
+void thread_1( UNUSED void *vargp ) {
+  mutex_lock( mutex_0 );
+  print_status( "1, 0 locked" );
+
+  /* T0 queues up on M0 meanwhile */
+  sleep_for( 10 );
+
+  mutex_lock( mutex_1 );
+  print_status( "1, 1 locked" );
+  mutex_unlock( mutex_0 );
+
+  int err = mutex_lock_timed( mutex_0, WAIT_FOREVER );
+  if ( err != 0 ) {
+    printf( "Test failed: T1 got %d instead of M0\n", err );
+    mutex_unlock( mutex_1 );
+    return;
+  }
+  print_status( "1, 0 locked again" );
+
+  mutex_unlock( mutex_0 );
+  mutex_unlock( mutex_1 );
+  printf( "Test passed\n" );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  mutex_0 = mutex_init( 0 );
+  if ( mutex_0 == NULL ) {
+    printf( "Failed to create mutex 0\n" );
+    return -1;
+  }
+
+  mutex_1 = mutex_init( 0 );
+  if ( mutex_1 == NULL ) {
+    printf( "Failed to create mutex 1\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( thread_create( &thread_0, 0, 20, 100, NULL ) );
+  ABORT_ON_ERROR( thread_create( &thread_1, 1, 30, 200, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file   main.c
+ *
+ * @brief  Software timers waking a thread and setting event flags.
+ *
+ * T0: (10, 500)
+ *
+ * A periodic timer (every 30 ticks) wakes the thread and a one-shot timer
+ * sets an event flag after 100 ticks, without either of them taking a
+ * thread slot. In its second period the thread sleeps on nothing but
+ * the timers. Cnt is the number of expirations each wait consumed.
+ *
+ * Expected output:
+ * t=30	Thread tick	Prio: 0	Cnt: 1
+ * t=60	Thread tick	Prio: 0	Cnt: 1
+ * t=90	Thread tick	Prio: 0	Cnt: 1
+ * t=100	Thread oneshot	Prio: 0	Cnt: 1
+ * t=500	Thread tick	Prio: 0	Cnt: 13
+ * t=500	Thread cancel	Prio: 0	Cnt: 1
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 1
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief Event flag set by the one-shot timer */
+#define ONESHOT_FLAG 0x1
+
+event_t *timeouts;
+swtimer_t *ticker;
+swtimer_t *oneshot;
+
+/** @brief Waits on both timers, then on the backlog of the periodic one
+ */
+void timer_thread( UNUSED void *vargp ) {
+  uint32_t flags;
+
+  ABORT_ON_ERROR( swtimer_start( ticker, 30, 30 ) );
+  ABORT_ON_ERROR( swtimer_start( oneshot, 100, 0 ) );
+
+  for ( int i = 0; i < 3; i++ ) {
+    int n = swtimer_wait( ticker, WAIT_FOREVER );
+    print_status_prio_cnt( "tick", n );
+  }
+  ABORT_ON_ERROR( event_wait( timeouts, ONESHOT_FLAG, EVENT_CLEAR, &flags ) );
+  print_status_prio_cnt( "oneshot", flags );
+
+  wait_until_next_period();
+
+  // Expirations since t=90 were counted while nobody waited
+  print_status_prio_cnt( "tick", swtimer_wait( ticker, 0 ) );
+  print_status_prio_cnt( "cancel", swtimer_cancel( ticker ) );
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  timeouts = event_init();
+  ticker = swtimer_create( NULL, 0 );
+  oneshot = swtimer_create( timeouts, ONESHOT_FLAG );
+  if ( timeouts == NULL || ticker == NULL || oneshot == NULL ) {
+    printf( "Failed to create timers\n" );
+    return -1;
+  }
+
+  ABORT_ON_ERROR( thread_create( &timer_thread, 0, 10, 500, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
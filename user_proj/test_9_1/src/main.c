@@ -0,0 +1,72 @@
+/**
+ * @file   main.c
+ *
+ * @brief  sleep_for() hands the CPU to lower priority threads.
+ *
+ * T0: sleeper (10, 200), T1: worker (50, 200)
+ *
+ * The sleeper does a little work, sleeps for 60 ticks and works again.
+ * While it sleeps the worker runs, where spin_until() would have kept the
+ * sleeper scheduled (and charged) the whole time.
+ *
+ * Expected output:
+ * t=0	Thread sleeper	Prio: 0	Cnt: 0
+ * t=5	Thread worker	Prio: 1	Cnt: 0
+ * t=65	Thread sleeper	Prio: 0	Cnt: 1
+ * t=200	Thread sleeper	Prio: 0	Cnt: 0
+ * ...
+ */
+#include <349_lib.h>
+#include <349_threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief thread user space stack size - 1KB */
+#define USR_STACK_WORDS 256
+#define NUM_THREADS 2
+#define NUM_MUTEXES 0
+#define CLOCK_FREQUENCY 1000
+
+/** @brief How much to reduce spin wait */
+#define REDUCE_SPIN_MS 2
+
+/** @brief Ticks the sleeper sleeps between its two bursts */
+#define SLEEP_TICKS 60
+
+/** @brief Works, sleeps and works again every period
+ */
+void sleeper_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < 5; cnt++ ) {
+    print_status_prio_cnt( "sleeper", 0 );
+    spin_wait( 5 - REDUCE_SPIN_MS );
+    ABORT_ON_ERROR( sleep_for( SLEEP_TICKS ) );
+    print_status_prio_cnt( "sleeper", 1 );
+    spin_wait( 5 - REDUCE_SPIN_MS );
+    wait_until_next_period();
+  }
+}
+
+/** @brief Lower priority work that fills the sleeper's gap
+ */
+void worker_thread( UNUSED void *vargp ) {
+  for ( int cnt = 0; cnt < 5; cnt++ ) {
+    print_status_prio_cnt( "worker", cnt );
+    spin_wait( 50 - REDUCE_SPIN_MS );
+    wait_until_next_period();
+  }
+}
+
+int main() {
+
+  ABORT_ON_ERROR( thread_init( NUM_THREADS, USR_STACK_WORDS, NULL, NUM_MUTEXES ) );
+
+  ABORT_ON_ERROR( thread_create( &sleeper_thread, 0, 10, 200, NULL ) );
+  ABORT_ON_ERROR( thread_create( &worker_thread, 1, 50, 200, NULL ) );
+
+  printf( "Starting scheduler...\n" );
+
+  ABORT_ON_ERROR( scheduler_start( CLOCK_FREQUENCY ) );
+
+  return 0;
+}
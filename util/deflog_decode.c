@@ -0,0 +1,267 @@
+/**
+ * @file   deflog_decode.c
+ *
+ * @brief  Host side decoder for deferred log records (kernel/include/deflog.h).
+ *
+ *         Reads the console output of the board, passes text through and
+ *         renders every log record with its format string, which it looks
+ *         up in the .deflog section of the ELF the board runs.
+ *
+ *         Build with "make decoder", then e.g.
+ *           stty -F /dev/ttyACM0 115200 raw
+ *           build/deflog_decode build/bin/<binary>.elf < /dev/ttyACM0
+ *         or decode a capture file given as the second argument.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <elf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFLOG_HOST
+#include "../kernel/include/deflog.h"
+
+/** @brief Longest conversion specification we rebuild for printf. */
+#define SPEC_MAX 32
+
+/** @brief Contents of the .deflog section. */
+static char *strings;
+
+/** @brief Size of the .deflog section. */
+static uint32_t strings_size;
+
+/**
+ * @brief Loads the .deflog section of a 32-bit little endian ELF.
+ *
+ * @param[in] path The ELF file.
+ * @return 0 on success, -1 on failure.
+ */
+static int load_strings(const char *path){
+  FILE *f = fopen(path, "rb");
+  if (f == NULL){
+    perror(path);
+    return -1;
+  }
+
+  Elf32_Ehdr eh;
+  if (fread(&eh, sizeof(eh), 1, f) != 1 || memcmp(eh.e_ident, ELFMAG, SELFMAG) != 0
+      || eh.e_ident[EI_CLASS] != ELFCLASS32 || eh.e_shentsize != sizeof(Elf32_Shdr)){
+    fprintf(stderr, "%s: not a 32-bit ELF file\n", path);
+    fclose(f);
+    return -1;
+  }
+
+  Elf32_Shdr *sh = calloc(eh.e_shnum, sizeof(Elf32_Shdr));
+  if (sh == NULL || fseek(f, eh.e_shoff, SEEK_SET) != 0
+      || fread(sh, sizeof(Elf32_Shdr), eh.e_shnum, f) != eh.e_shnum
+      || eh.e_shstrndx >= eh.e_shnum){
+    fprintf(stderr, "%s: bad section headers\n", path);
+    free(sh);
+    fclose(f);
+    return -1;
+  }
+
+  Elf32_Shdr *names = &sh[eh.e_shstrndx];
+  char *shstr = malloc(names->sh_size);
+  if (shstr == NULL || fseek(f, names->sh_offset, SEEK_SET) != 0
+      || fread(shstr, 1, names->sh_size, f) != names->sh_size){
+    fprintf(stderr, "%s: bad section names\n", path);
+    free(shstr);
+    free(sh);
+    fclose(f);
+    return -1;
+  }
+
+  int err = -1;
+  for (int i = 0; i < eh.e_shnum; i++){
+    if (sh[i].sh_name >= names->sh_size || strcmp(&shstr[sh[i].sh_name], ".deflog") != 0){
+      continue;
+    }
+    /* IDs are addresses, the linker script starts the section at 0 */
+    strings_size = sh[i].sh_addr + sh[i].sh_size;
+    strings = calloc(strings_size + 1, 1);
+    if (strings != NULL && fseek(f, sh[i].sh_offset, SEEK_SET) == 0
+        && fread(strings + sh[i].sh_addr, 1, sh[i].sh_size, f) == sh[i].sh_size){
+      err = 0;
+    }
+    break;
+  }
+  if (err < 0){
+    fprintf(stderr, "%s: no .deflog section\n", path);
+  }
+
+  free(shstr);
+  free(sh);
+  fclose(f);
+  return err;
+}
+
+/**
+ * @brief Prints one record.
+ *
+ * @param[in] id Offset of the format string in .deflog.
+ * @param[in] args The arguments.
+ * @param[in] nargs Number of arguments.
+ */
+static void render(uint32_t id, const uint32_t *args, uint32_t nargs){
+  if (id >= strings_size){
+    printf("<deflog: unknown string %u>\n", id);
+    return;
+  }
+
+  const char *p = &strings[id];
+  uint32_t next = 0;
+
+  while (*p != '\0'){
+    if (*p != '%'){
+      /* Every record gets its own line, with or without a trailing newline */
+      if (!(p[0] == '\n' && p[1] == '\0')){
+        putchar(*p);
+      }
+      p++;
+      continue;
+    }
+    if (p[1] == '%'){
+      putchar('%');
+      p += 2;
+      continue;
+    }
+
+    /* Rebuild the specification without length modifiers, * is an argument */
+    char spec[SPEC_MAX];
+    int len = 0;
+    spec[len++] = *p++;
+    while (*p != '\0' && strchr("-+ #0123456789.*hlLqjzt", *p) != NULL && len < SPEC_MAX - 8){
+      if (*p == '*'){
+        len += snprintf(&spec[len], SPEC_MAX - len, "%d", next < nargs ? (int32_t)args[next] : 0);
+        next++;
+      }
+      else if (strchr("hlLqjzt", *p) == NULL){
+        spec[len++] = *p;
+      }
+      p++;
+    }
+
+    char conv = *p;
+    if (conv == '\0'){
+      break;
+    }
+    p++;
+    if (next >= nargs){
+      printf("<missing>");
+      continue;
+    }
+    uint32_t arg = args[next++];
+
+    switch (conv){
+      case 'd':
+      case 'i':
+        spec[len++] = 'd';
+        spec[len] = '\0';
+        printf(spec, (int)(int32_t)arg);
+        break;
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+      case 'c':
+        spec[len++] = conv;
+        spec[len] = '\0';
+        printf(spec, (unsigned int)arg);
+        break;
+      case 'p':
+        printf("0x%08x", arg);
+        break;
+      default:
+        printf("<%%%c unsupported>", conv);
+        break;
+    }
+  }
+  putchar('\n');
+}
+
+/**
+ * @brief Reads n bytes of a record.
+ *
+ * @return 0 on success, -1 at the end of the input.
+ */
+static int read_bytes(FILE *in, uint8_t *buf, uint32_t n){
+  return fread(buf, 1, n, in) == n ? 0 : -1;
+}
+
+int main(int argc, char **argv){
+  if (argc < 2 || argc > 3){
+    fprintf(stderr, "usage: %s <elf> [capture]\n", argv[0]);
+    return 1;
+  }
+  if (load_strings(argv[1]) < 0){
+    return 1;
+  }
+
+  FILE *in = stdin;
+  if (argc == 3 && (in = fopen(argv[2], "rb")) == NULL){
+    perror(argv[2]);
+    return 1;
+  }
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  /* Records are never split by text, so the header follows the marker */
+  int c;
+  int line_start = 1;
+  while ((c = fgetc(in)) != EOF){
+    if (c != DEFLOG_MARKER){
+      putchar(c);
+      line_start = (c == '\n');
+      continue;
+    }
+
+    uint8_t hdr[DEFLOG_HEADER - 1];
+    uint8_t raw[4 * DEFLOG_MAX_ARGS];
+    uint32_t args[DEFLOG_MAX_ARGS];
+    if (read_bytes(in, hdr, sizeof(hdr)) < 0){
+      break;
+    }
+    uint32_t nargs = hdr[0];
+    uint32_t id = hdr[1] | (hdr[2] << 8);
+    if (nargs > DEFLOG_MAX_ARGS){
+      printf("<deflog: bad record>\n");
+      continue;
+    }
+    if (read_bytes(in, raw, 4 * nargs) < 0){
+      break;
+    }
+    for (uint32_t i = 0; i < nargs; i++){
+      args[i] = raw[4 * i] | (raw[4 * i + 1] << 8) | (raw[4 * i + 2] << 16) | ((uint32_t)raw[4 * i + 3] << 24);
+    }
+    /* Scheduler trace dumps are for sched_trace_json */
+    if (id == DEFLOG_ID_SCHED_TRACE){
+      continue;
+    }
+    /* FD_TRACE text continues the text around it */
+    if (id == DEFLOG_ID_TEXT){
+      for (uint32_t i = 0; i < 4 * nargs && raw[i] != '\0'; i++){
+        putchar(raw[i]);
+        line_start = (raw[i] == '\n');
+      }
+      continue;
+    }
+
+    /* A record may land in the middle of a text line */
+    if (!line_start){
+      putchar('\n');
+    }
+    render(id, args, nargs);
+    line_start = 1;
+  }
+
+  if (in != stdin){
+    fclose(in);
+  }
+  free(strings);
+  return 0;
+}
@@ -0,0 +1,418 @@
+/**
+ * @file   itm_timeline.c
+ *
+ * @brief  Host side decoder for the kernel ITM trace (kernel/include/itm.h).
+ *
+ *         Parses a raw SWO byte stream (UART/NRZ encoding) the same way as
+ *         OpenOCD's contrib/itmdump.c, picks out the kernel event ports and
+ *         rebuilds what ran when: the slices of every thread, the syscalls
+ *         they made, the interrupts that cut into them and the user markers.
+ *
+ *         Capture with a kernel built with ITM_TRACE=1, e.g. from the
+ *         OpenOCD telnet console (the TPIU runs from the 16MHz core clock):
+ *           tpiu config internal /tmp/swo.bin uart off 16000000 2000000
+ *         and decode live or later, as often as needed:
+ *           build/itm_timeline [-e] [-t] [-c hz] /tmp/swo.bin
+ *
+ *         -e prints every event and the text written to FD_TRACE, -t
+ *         prints the slices of each thread, -c
+ *         sets the core clock used to turn cycles into microseconds.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief Stimulus ports, must match kernel/include/itm.h */
+//@{
+#define ITM_PORT_TEXT      0
+#define ITM_PORT_SWITCH    1
+#define ITM_PORT_SVC_ENTER 2
+#define ITM_PORT_SVC_EXIT  3
+#define ITM_PORT_ISR_ENTER 4
+#define ITM_PORT_ISR_EXIT  5
+#define ITM_PORT_MARKER    6
+//@}
+
+/** @brief Bits of DWT_CYCCNT carried by every event */
+#define ITM_TIME_BITS 24
+
+/** @brief Thread indices fit in 4 bits */
+#define MAX_THREADS 16
+
+/** @brief Exception numbers fit in 8 bits */
+#define MAX_EXCEPTIONS 256
+
+/** @brief Deepest interrupt nesting tracked */
+#define MAX_NESTING 8
+
+/** @brief Marker IDs fit in 8 bits */
+#define MAX_MARKERS 256
+
+/** @brief Longest line of FD_TRACE text shown as one event */
+#define MAX_TEXT 128
+
+/** @brief One stretch of time a thread had the CPU. */
+typedef struct {
+  uint64_t start;  /**< Cycle the thread was switched in. */
+  uint64_t end;    /**< Cycle it was switched out. */
+} slice_t;
+
+/** @brief What we know about one thread. */
+typedef struct {
+  uint64_t run;        /**< Cycles between being switched in and out. */
+  uint64_t irq;        /**< Part of run spent in interrupts. */
+  uint64_t max_slice;  /**< Longest slice. */
+  uint32_t syscalls;   /**< Syscalls entered. */
+  uint32_t markers;    /**< Markers emitted. */
+  uint32_t count;      /**< Number of slices. */
+  slice_t *slices;     /**< Every slice, for -t. */
+  uint32_t nslices;    /**< Slices stored. */
+  uint32_t cap;        /**< Room in slices. */
+} thread_stats_t;
+
+/** @brief What we know about one exception number. */
+typedef struct {
+  uint32_t count;  /**< Times entered. */
+  uint64_t total;  /**< Cycles spent, nested interrupts included. */
+  uint64_t max;    /**< Longest single run. */
+} isr_stats_t;
+
+static thread_stats_t threads[MAX_THREADS];
+static isr_stats_t isrs[MAX_EXCEPTIONS];
+static uint32_t markers[MAX_MARKERS];
+
+/** @brief Decoder state */
+//@{
+static int print_events;
+static int print_slices;
+static double cycles_per_us = 16.0;
+static uint64_t now;            /**< Unwrapped cycle count of the last event. */
+static uint32_t last_stamp;     /**< Raw 24-bit stamp of the last event. */
+static int have_time;           /**< Whether last_stamp is valid. */
+static int current = -1;        /**< Running thread, -1 until the first switch. */
+static uint64_t slice_start;    /**< When current was switched in. */
+static uint64_t first_time;     /**< Time of the first event. */
+static uint32_t isr_depth;      /**< Interrupt nesting level. */
+static uint64_t isr_start[MAX_NESTING];
+static uint32_t isr_number[MAX_NESTING];
+static uint32_t events;         /**< Kernel events decoded. */
+static uint32_t overflows;      /**< ITM overflow packets. */
+static uint32_t resyncs;        /**< Switches whose from did not match. */
+static char text[MAX_TEXT + 1]; /**< FD_TRACE text not printed yet. */
+static uint32_t text_len;
+//@}
+
+/**
+ * @brief Turns a cycle count into microseconds since the first event.
+ */
+static double us(uint64_t cycles){
+  return (cycles - first_time) / cycles_per_us;
+}
+
+/**
+ * @brief Adds a slice to a thread.
+ */
+static void add_slice(int thread, uint64_t start, uint64_t end){
+  thread_stats_t *t = &threads[thread];
+  uint64_t len = end - start;
+
+  t->run += len;
+  t->count++;
+  if (len > t->max_slice){
+    t->max_slice = len;
+  }
+  if (!print_slices){
+    return;
+  }
+  if (t->nslices == t->cap){
+    t->cap = t->cap ? 2 * t->cap : 64;
+    t->slices = realloc(t->slices, t->cap * sizeof(slice_t));
+    if (t->slices == NULL){
+      perror("realloc");
+      exit(1);
+    }
+  }
+  t->slices[t->nslices].start = start;
+  t->slices[t->nslices].end = end;
+  t->nslices++;
+}
+
+/**
+ * @brief Handles one kernel event.
+ *
+ * @param[in] port Stimulus port.
+ * @param[in] word The 32-bit payload.
+ */
+static void kernel_event(uint32_t port, uint32_t word){
+  uint32_t stamp = word & ((1u << ITM_TIME_BITS) - 1);
+  uint32_t data = word >> ITM_TIME_BITS;
+
+  /* Events come at least every tick, so the stamp wraps at most once */
+  if (have_time){
+    now += (stamp - last_stamp) & ((1u << ITM_TIME_BITS) - 1);
+  }
+  else {
+    now = stamp;
+    first_time = now;
+    have_time = 1;
+  }
+  last_stamp = stamp;
+  events++;
+
+  switch (port){
+    case ITM_PORT_SWITCH: {
+      int from = data & 0xF;
+      int to = data >> 4;
+      if (current >= 0){
+        add_slice(current, slice_start, now);
+      }
+      if (current >= 0 && from != current){
+        resyncs++;
+      }
+      if (print_events){
+        printf("%12.3f us  switch  T%d -> T%d\n", us(now), from, to);
+      }
+      current = to;
+      slice_start = now;
+      break;
+    }
+    case ITM_PORT_SVC_ENTER:
+      if (current >= 0){
+        threads[current].syscalls++;
+      }
+      if (print_events){
+        printf("%12.3f us  T%-2d     svc %u enter\n", us(now), current, data);
+      }
+      break;
+    case ITM_PORT_SVC_EXIT:
+      if (print_events){
+        printf("%12.3f us  T%-2d     svc %u exit\n", us(now), current, data);
+      }
+      break;
+    case ITM_PORT_ISR_ENTER:
+      if (isr_depth < MAX_NESTING){
+        isr_start[isr_depth] = now;
+        isr_number[isr_depth] = data;
+      }
+      isr_depth++;
+      if (print_events){
+        printf("%12.3f us  T%-2d     isr %u enter\n", us(now), current, data);
+      }
+      break;
+    case ITM_PORT_ISR_EXIT:
+      if (isr_depth > 0){
+        isr_depth--;
+        if (isr_depth < MAX_NESTING && isr_number[isr_depth] == data){
+          uint64_t len = now - isr_start[isr_depth];
+          isrs[data].count++;
+          isrs[data].total += len;
+          if (len > isrs[data].max){
+            isrs[data].max = len;
+          }
+          /* Only the outermost interrupt is charged, nested ones are inside it */
+          if (isr_depth == 0 && current >= 0){
+            threads[current].irq += len;
+          }
+        }
+      }
+      if (print_events){
+        printf("%12.3f us  T%-2d     isr %u exit\n", us(now), current, data);
+      }
+      break;
+    case ITM_PORT_MARKER:
+      markers[data]++;
+      if (current >= 0){
+        threads[current].markers++;
+      }
+      if (print_events){
+        printf("%12.3f us  T%-2d     marker %u\n", us(now), current, data);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Collects FD_TRACE text, printed a line at a time with -e. The
+ *        text has no timestamp, so it shows the time of the last event.
+ */
+static void text_byte(char c){
+  if (c != '\n'){
+    text[text_len++] = c;
+  }
+  if (c == '\n' || text_len == MAX_TEXT){
+    text[text_len] = '\0';
+    if (print_events){
+      printf("%12.3f us  T%-2d     \"%s\"\n", have_time ? us(now) : 0.0, current, text);
+    }
+    text_len = 0;
+  }
+}
+
+/**
+ * @brief Reads the rest of a packet whose bytes continue while bit 7 is
+ *        set, as for timestamp and extension packets.
+ */
+static void skip_continuation(FILE *in, int c){
+  while ((c & 0x80) && (c = fgetc(in)) != EOF){
+  }
+}
+
+/**
+ * @brief Parses the ITM packet stream, see appendix D of the ARMv7-M
+ *        Architecture Reference Manual.
+ */
+static void parse(FILE *in){
+  int c;
+
+  while ((c = fgetc(in)) != EOF){
+    if (c == 0x00 || c == 0x80){
+      /* Synchronization: zeros closed by 0x80 */
+      continue;
+    }
+    if (c == 0x70){
+      overflows++;
+      if (print_events){
+        printf("%12s     ITM overflow, events lost\n", "");
+      }
+      continue;
+    }
+    if ((c & 0x0F) == 0x00){
+      /* Local or global timestamp, not used by the kernel events */
+      skip_continuation(in, c);
+      continue;
+    }
+    if ((c & 0x0B) == 0x08){
+      /* Extension */
+      skip_continuation(in, c);
+      continue;
+    }
+    if ((c & 0x03) == 0){
+      /* Reserved */
+      continue;
+    }
+
+    uint32_t size = (c & 0x03) == 3 ? 4 : (c & 0x03);
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < size; i++){
+      int b = fgetc(in);
+      if (b == EOF){
+        return;
+      }
+      value |= (uint32_t)b << (8 * i);
+    }
+
+    /* Software source, i.e. a stimulus port write of the kernel */
+    if (!(c & 0x04) && (c >> 3) == ITM_PORT_TEXT){
+      for (uint32_t i = 0; i < size; i++){
+        text_byte(value >> (8 * i));
+      }
+    }
+    else if (!(c & 0x04) && size == 4){
+      kernel_event(c >> 3, value);
+    }
+  }
+}
+
+/**
+ * @brief Prints the per-thread, per-interrupt and per-marker totals.
+ */
+static void print_summary(){
+  if (current >= 0){
+    add_slice(current, slice_start, now);
+  }
+  uint64_t total = now - first_time;
+
+  printf("\n%u events over %.3f us", events, us(now));
+  printf(", %u ITM overflows, %u resyncs\n\n", overflows, resyncs);
+
+  printf("thread   run us   share   irq us  slices  longest us  syscalls  markers\n");
+  for (int i = 0; i < MAX_THREADS; i++){
+    thread_stats_t *t = &threads[i];
+    if (t->run == 0 && t->syscalls == 0){
+      continue;
+    }
+    printf("T%-2d  %10.1f  %5.1f%%  %7.1f  %6u  %10.1f  %8u  %7u\n", i,
+           t->run / cycles_per_us, total ? 100.0 * t->run / total : 0.0,
+           t->irq / cycles_per_us, t->count, t->max_slice / cycles_per_us,
+           t->syscalls, t->markers);
+  }
+
+  printf("\nexception  count   total us   longest us\n");
+  for (int i = 0; i < MAX_EXCEPTIONS; i++){
+    if (isrs[i].count != 0){
+      printf("%9d  %5u  %9.1f  %11.1f\n", i, isrs[i].count,
+             isrs[i].total / cycles_per_us, isrs[i].max / cycles_per_us);
+    }
+  }
+
+  for (int i = 0; i < MAX_MARKERS; i++){
+    if (markers[i] != 0){
+      printf("\nmarker %d: %u", i, markers[i]);
+    }
+  }
+  printf("\n");
+
+  if (!print_slices){
+    return;
+  }
+  for (int i = 0; i < MAX_THREADS; i++){
+    thread_stats_t *t = &threads[i];
+    if (t->nslices == 0){
+      continue;
+    }
+    printf("\nT%d timeline (start us, end us, length us)\n", i);
+    for (uint32_t s = 0; s < t->nslices; s++){
+      printf("  %12.3f %12.3f %10.3f\n", us(t->slices[s].start), us(t->slices[s].end),
+             (t->slices[s].end - t->slices[s].start) / cycles_per_us);
+    }
+  }
+}
+
+int main(int argc, char **argv){
+  int opt;
+  while ((opt = getopt(argc, argv, "etc:")) != -1){
+    switch (opt){
+      case 'e':
+        print_events = 1;
+        break;
+      case 't':
+        print_slices = 1;
+        break;
+      case 'c':
+        cycles_per_us = atof(optarg) / 1e6;
+        if (cycles_per_us <= 0){
+          fprintf(stderr, "bad clock %s\n", optarg);
+          return 1;
+        }
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-e] [-t] [-c hz] [capture]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  FILE *in = stdin;
+  if (optind < argc && (in = fopen(argv[optind], "rb")) == NULL){
+    perror(argv[optind]);
+    return 1;
+  }
+
+  parse(in);
+  print_summary();
+
+  if (in != stdin){
+    fclose(in);
+  }
+  for (int i = 0; i < MAX_THREADS; i++){
+    free(threads[i].slices);
+  }
+  return 0;
+}
@@ -0,0 +1,336 @@
+/**
+ * @file   sched_trace_json.c
+ *
+ * @brief  Host side converter of scheduler trace dumps (kernel/include/
+ *         sched_trace.h) to Chrome trace-event JSON, which chrome://tracing
+ *         and ui.perfetto.dev show as a timeline.
+ *
+ *         Reads the console output of the board, skips text and other log
+ *         records and turns the records of every sched_trace_dump() into
+ *         one row per thread, with the slices it ran and its releases,
+ *         budget overruns and mutex waits, and one row per mutex with the
+ *         time each owner held it.
+ *
+ *         Build with "make decoder", then e.g.
+ *           stty -F /dev/ttyACM0 115200 raw
+ *           cat /dev/ttyACM0 | tee capture.bin | build/deflog_decode <elf>
+ *           build/sched_trace_json capture.bin > trace.json
+ *
+ *         -c sets the core clock used to turn cycles into microseconds.
+ *
+ * @date   October 18 2026
+ *
+ * @author Mario Cruz and Charlie Ai
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define DEFLOG_HOST
+#include "../kernel/include/deflog.h"
+
+/** @brief Events, must match kernel/include/sched_trace.h */
+//@{
+#define SCHED_TRACE_START   0
+#define SCHED_TRACE_SWITCH  1
+#define SCHED_TRACE_RELEASE 2
+#define SCHED_TRACE_BUDGET  3
+#define SCHED_TRACE_LOCK    4
+#define SCHED_TRACE_BLOCK   5
+#define SCHED_TRACE_UNLOCK  6
+//@}
+
+/** @brief Process IDs of the two groups of rows */
+//@{
+#define PID_THREADS 0
+#define PID_MUTEXES 1
+//@}
+
+/** @brief Threads and mutexes are numbered in 8 bits */
+#define MAX_IDS 256
+
+/** @brief Converter state */
+//@{
+static double cycles_per_us = 16.0;
+static uint64_t now;              /**< Unwrapped cycle count of the last record. */
+static uint64_t origin;           /**< Time of the first record. */
+static uint32_t last_cycles;      /**< Raw cycles of the last record. */
+static int have_time;             /**< Whether last_cycles is valid. */
+static int current = -1;          /**< Running thread, -1 at the start of a dump. */
+static uint32_t current_priority; /**< Its dynamic priority. */
+static uint64_t slice_start;      /**< When current was switched in. */
+static int owner[MAX_IDS];        /**< Owner of every mutex, -1 if free. */
+static uint32_t owner_priority[MAX_IDS];
+static uint64_t hold_start[MAX_IDS];
+static uint8_t thread_seen[MAX_IDS];
+static uint8_t mutex_seen[MAX_IDS];
+static int max_threads = -1;      /**< From the last dump, names idle and main. */
+static uint32_t records;          /**< Trace records converted. */
+static int first_event = 1;       /**< No comma before the first event. */
+//@}
+
+/**
+ * @brief Turns a cycle count into microseconds since the first record.
+ */
+static double us(uint64_t cycles){
+  return (cycles - origin) / cycles_per_us;
+}
+
+/**
+ * @brief Prints one trace event object.
+ */
+static void emit(const char *fmt, ...){
+  va_list ap;
+  printf(first_event ? "\n  " : ",\n  ");
+  first_event = 0;
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+}
+
+/**
+ * @brief Ends the slice of the running thread.
+ */
+static void end_slice(){
+  if (current >= 0){
+    emit("{\"name\":\"run\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+         "\"args\":{\"priority\":%u}}",
+         PID_THREADS, current, us(slice_start), (now - slice_start) / cycles_per_us,
+         current_priority);
+  }
+  current = -1;
+}
+
+/**
+ * @brief Starts a new slice when the running thread changes priority, so
+ *        every slice shows the priority it ran at.
+ */
+static void set_priority(uint32_t thread, uint32_t priority){
+  if ((int)thread == current && priority != current_priority){
+    end_slice();
+    current = thread;
+    current_priority = priority;
+    slice_start = now;
+  }
+}
+
+/**
+ * @brief Ends the hold of a mutex.
+ */
+static void end_hold(uint32_t mutex){
+  if (owner[mutex] >= 0){
+    emit("{\"name\":\"T%d\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+         "\"args\":{\"owner\":%d,\"priority\":%u}}",
+         owner[mutex], PID_MUTEXES, mutex, us(hold_start[mutex]),
+         (now - hold_start[mutex]) / cycles_per_us, owner[mutex], owner_priority[mutex]);
+  }
+  owner[mutex] = -1;
+}
+
+/**
+ * @brief Prints an instant event on a thread's row.
+ */
+static void instant(const char *name, uint32_t thread, uint32_t priority, uint32_t mutex){
+  if (mutex < 0xFF){
+    emit("{\"name\":\"%s M%u\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,"
+         "\"args\":{\"priority\":%u,\"mutex\":%u}}",
+         name, mutex, PID_THREADS, thread, us(now), priority, mutex);
+  }
+  else {
+    emit("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,"
+         "\"args\":{\"priority\":%u}}",
+         name, PID_THREADS, thread, us(now), priority);
+  }
+}
+
+/**
+ * @brief Converts one trace record.
+ *
+ * @param[in] cycles First argument of the record.
+ * @param[in] info Second argument of the record.
+ */
+static void trace_record(uint32_t cycles, uint32_t info){
+  uint32_t event = info & 0xFF;
+  uint32_t thread = (info >> 8) & 0xFF;
+  uint32_t priority = (info >> 16) & 0xFF;
+  uint32_t mutex = info >> 24;
+
+  /* A dump starts where the last one stopped, so nothing is running yet */
+  if (event == SCHED_TRACE_START){
+    end_slice();
+    for (int i = 0; i < MAX_IDS; i++){
+      end_hold(i);
+    }
+    max_threads = thread;
+    if (cycles != 0 && have_time){
+      emit("{\"name\":\"%u records lost\",\"ph\":\"i\",\"s\":\"g\",\"pid\":%d,\"tid\":0,"
+           "\"ts\":%.3f}", cycles, PID_THREADS, us(now));
+    }
+    return;
+  }
+
+  /* Records of a dump are at most 2^32 cycles apart, like the counter */
+  if (have_time){
+    now += (uint32_t)(cycles - last_cycles);
+  }
+  else {
+    now = cycles;
+    origin = now;
+    have_time = 1;
+  }
+  last_cycles = cycles;
+  records++;
+  thread_seen[thread] = 1;
+
+  switch (event){
+    case SCHED_TRACE_SWITCH:
+      end_slice();
+      current = thread;
+      current_priority = priority;
+      slice_start = now;
+      break;
+    case SCHED_TRACE_RELEASE:
+      instant("release", thread, priority, 0xFF);
+      break;
+    case SCHED_TRACE_BUDGET:
+      instant("budget used", thread, priority, 0xFF);
+      break;
+    case SCHED_TRACE_BLOCK:
+      instant("block", thread, priority, mutex);
+      break;
+    case SCHED_TRACE_LOCK:
+      end_hold(mutex);
+      mutex_seen[mutex] = 1;
+      owner[mutex] = thread;
+      owner_priority[mutex] = priority;
+      hold_start[mutex] = now;
+      instant("lock", thread, priority, mutex);
+      set_priority(thread, priority);
+      break;
+    case SCHED_TRACE_UNLOCK:
+      end_hold(mutex);
+      instant("unlock", thread, priority, mutex);
+      set_priority(thread, priority);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Names the rows and orders the threads by priority.
+ */
+static void emit_names(){
+  emit("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"threads\"}}",
+       PID_THREADS);
+  emit("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"mutexes\"}}",
+       PID_MUTEXES);
+
+  for (int i = 0; i < MAX_IDS; i++){
+    if (thread_seen[i]){
+      if (i == max_threads){
+        emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+             "\"args\":{\"name\":\"idle\"}}", PID_THREADS, i);
+      }
+      else if (max_threads >= 0 && i == max_threads + 1){
+        emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+             "\"args\":{\"name\":\"main\"}}", PID_THREADS, i);
+      }
+      else {
+        emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+             "\"args\":{\"name\":\"T%d\"}}", PID_THREADS, i, i);
+      }
+      emit("{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+           "\"args\":{\"sort_index\":%d}}", PID_THREADS, i, i);
+    }
+    if (mutex_seen[i]){
+      emit("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+           "\"args\":{\"name\":\"M%d\"}}", PID_MUTEXES, i, i);
+    }
+  }
+}
+
+/**
+ * @brief Reads n bytes of a record.
+ *
+ * @return 0 on success, -1 at the end of the input.
+ */
+static int read_bytes(FILE *in, uint8_t *buf, uint32_t n){
+  return fread(buf, 1, n, in) == n ? 0 : -1;
+}
+
+int main(int argc, char **argv){
+  int opt;
+  while ((opt = getopt(argc, argv, "c:")) != -1){
+    switch (opt){
+      case 'c':
+        cycles_per_us = atof(optarg) / 1e6;
+        if (cycles_per_us <= 0){
+          fprintf(stderr, "bad clock %s\n", optarg);
+          return 1;
+        }
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-c hz] [capture]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  FILE *in = stdin;
+  if (optind < argc && (in = fopen(argv[optind], "rb")) == NULL){
+    perror(argv[optind]);
+    return 1;
+  }
+
+  for (int i = 0; i < MAX_IDS; i++){
+    owner[i] = -1;
+  }
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+  /* Text is skipped, every record is parsed to find the trace ones */
+  int c;
+  while ((c = fgetc(in)) != EOF){
+    if (c != DEFLOG_MARKER){
+      continue;
+    }
+
+    uint8_t hdr[DEFLOG_HEADER - 1];
+    uint8_t raw[4 * DEFLOG_MAX_ARGS];
+    if (read_bytes(in, hdr, sizeof(hdr)) < 0){
+      break;
+    }
+    uint32_t nargs = hdr[0];
+    uint32_t id = hdr[1] | (hdr[2] << 8);
+    if (nargs > DEFLOG_MAX_ARGS){
+      continue;
+    }
+    if (read_bytes(in, raw, 4 * nargs) < 0){
+      break;
+    }
+    if (id != DEFLOG_ID_SCHED_TRACE || nargs != 2){
+      continue;
+    }
+
+    uint32_t cycles = raw[0] | (raw[1] << 8) | (raw[2] << 16) | ((uint32_t)raw[3] << 24);
+    uint32_t info = raw[4] | (raw[5] << 8) | (raw[6] << 16) | ((uint32_t)raw[7] << 24);
+    trace_record(cycles, info);
+  }
+
+  /* Whatever is still running or held ends with the last record */
+  end_slice();
+  for (int i = 0; i < MAX_IDS; i++){
+    end_hold(i);
+  }
+  emit_names();
+  printf("\n]}\n");
+
+  fprintf(stderr, "%u records, %.3f us\n", records, have_time ? us(now) : 0.0);
+
+  if (in != stdin){
+    fclose(in);
+  }
+  return 0;
+}